@@ -0,0 +1,43 @@
+<?php
+// compact() on ~11.5M cells, sorted (streaming path) versus shuffled (libh3
+// compactCells()).
+//
+// Usage: php -d extension=h3.so -d memory_limit=-1 benchmarks/compact.php [iterations]
+
+$iterations = (int) ($argv[1] ?? 3);
+
+// every res 11 child of two res 3 cells, with every 1000th cell missing so
+// the result mixes resolutions 3 to 11
+$sorted = [];
+foreach ([0x832830fffffffff, 0x832834fffffffff] as $parent) {
+    foreach (array_keys(\H3\H3Index::fromLong($parent)->toChildren(11, H3_OUTPUT_SET)) as $i => $cell) {
+        if ($i % 1000 !== 7) {
+            $sorted[] = $cell;
+        }
+    }
+}
+$sorted = \H3\sort_cells($sorted);
+
+$shuffled = $sorted;
+shuffle($shuffled);
+
+$benchmarks = [
+    'sorted' => fn () => \H3\compact($sorted),
+    'shuffled' => fn () => \H3\compact($shuffled),
+    'sort_cells + sorted' => fn () => \H3\compact(\H3\sort_cells($shuffled)),
+];
+
+printf("%d cells\n", count($sorted));
+printf("%-24s %12s %10s\n", 'benchmark', 'ms', 'cells out');
+
+foreach ($benchmarks as $name => $benchmark) {
+    $count = count($benchmark());
+
+    $start = hrtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $benchmark();
+    }
+    $ms = (hrtime(true) - $start) / 1e6 / $iterations;
+
+    printf("%-24s %12.2f %10d\n", $name, $ms, $count);
+}
@@ -0,0 +1,43 @@
+<?php
+// Hex encoding and decoding of cell ids, one at a time and in batches.
+//
+// Usage: php -d extension=h3.so -d memory_limit=-1 benchmarks/hex.php [count]
+
+$count = (int) ($argv[1] ?? 1000000);
+
+$ids = array_map(fn ($cell) => $cell->toLong(), (new \H3\H3Index(0x85283473fffffff))->toChildren(12));
+$ids = array_slice(array_merge(...array_fill(0, (int) ceil($count / count($ids)), $ids)), 0, $count);
+$objects = array_map(fn ($id) => new \H3\H3Index($id), $ids);
+$strings = \H3\cells_to_strings($ids);
+$joined = \H3\cells_to_strings($ids, true);
+
+$benchmarks = [
+    'toString()' => function () use ($objects) {
+        foreach ($objects as $object) {
+            $object->toString();
+        }
+    },
+    'fromString()' => function () use ($strings) {
+        foreach ($strings as $string) {
+            \H3\H3Index::fromString($string);
+        }
+    },
+    'dechex()' => function () use ($ids) {
+        foreach ($ids as $id) {
+            dechex($id);
+        }
+    },
+    'cells_to_strings()' => fn () => \H3\cells_to_strings($ids),
+    'cells_to_strings(joined)' => fn () => \H3\cells_to_strings($ids, true),
+    'strings_to_cells()' => fn () => \H3\strings_to_cells($strings),
+    'strings_to_cells(lines)' => fn () => \H3\strings_to_cells($joined),
+];
+
+printf("%d ids\n", count($ids));
+printf("%-28s %12s\n", 'benchmark', 'ns/id');
+
+foreach ($benchmarks as $name => $benchmark) {
+    $start = hrtime(true);
+    $benchmark();
+    printf("%-28s %12.1f\n", $name, (hrtime(true) - $start) / count($ids));
+}
@@ -0,0 +1,41 @@
+<?php
+// cells_to_parents() on ~1M res 11 cells, packed and as an array, versus
+// H3Index::toParent() per cell. The packed run is close to the bare masking
+// kernel; the per-cell run calls cellToParent() and builds an H3Index for
+// every cell.
+//
+// Usage: php -d extension=h3.so -d memory_limit=-1 benchmarks/parents.php [iterations]
+
+$iterations = (int) ($argv[1] ?? 5);
+
+// every res 11 child of a res 4 cell
+$cells = array_keys(\H3\H3Index::fromLong(0x8428309ffffffff)->toChildren(11, H3_OUTPUT_SET));
+$packed = pack('Q*', ...$cells);
+$objects = array_map(fn ($cell) => \H3\H3Index::fromLong($cell), $cells);
+
+$benchmarks = [
+    'cells_to_parents packed' => fn () => \H3\cells_to_parents($packed, 7, true),
+    'cells_to_parents array' => fn () => \H3\cells_to_parents($cells, 7),
+    'toParent() per cell' => function () use ($objects) {
+        $parents = [];
+        foreach ($objects as $cell) {
+            $parents[] = $cell->toParent(7);
+        }
+        return $parents;
+    },
+];
+
+printf("%d cells\n", count($cells));
+printf("%-24s %12s %12s\n", 'benchmark', 'ms', 'ns per cell');
+
+foreach ($benchmarks as $name => $benchmark) {
+    $benchmark();
+
+    $start = hrtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $benchmark();
+    }
+    $ms = (hrtime(true) - $start) / 1e6 / $iterations;
+
+    printf("%-24s %12.2f %12.2f\n", $name, $ms, $ms * 1e6 / count($cells));
+}
@@ -0,0 +1,42 @@
+<?php
+// polyfill() of the same polygons under the h3.result_cache_size the process
+// was started with. Hits skip the fill and only build the returned H3Index
+// objects. The setting is system-wide, so compare two runs:
+//
+// Usage: php -d extension=h3.so -d h3.result_cache_size=0 benchmarks/result_cache.php [iterations]
+//        php -d extension=h3.so -d h3.result_cache_size=64M benchmarks/result_cache.php [iterations]
+
+$iterations = (int) ($argv[1] ?? 20);
+
+$polygons = [];
+for ($i = 0; $i < 20; $i++) {
+    $lat = 37.7 + $i * 0.01;
+    $lng = -122.5 + $i * 0.01;
+    $polygons[] = new \H3\GeoPolygon(new \H3\CellBoundary([
+        new \H3\LatLng($lat, $lng),
+        new \H3\LatLng($lat - 0.05, $lng + 0.04),
+        new \H3\LatLng($lat + 0.01, $lng + 0.08),
+    ]));
+}
+
+$name = ini_get('h3.result_cache_size') ? 'cached' : 'uncached';
+
+printf("%-24s %12s %10s\n", 'benchmark', 'ms', 'cells out');
+
+$count = 0;
+foreach ($polygons as $polygon) {
+    $count += count(\H3\polyfill($polygon, 10));
+}
+
+$start = hrtime(true);
+for ($i = 0; $i < $iterations; $i++) {
+    foreach ($polygons as $polygon) {
+        \H3\polyfill($polygon, 10);
+    }
+}
+$ms = (hrtime(true) - $start) / 1e6 / $iterations;
+
+printf("%-24s %12.2f %10d\n", $name, $ms, $count);
+
+$stats = \H3\result_cache_stats();
+printf("%d entries, %d bytes, %d hits, %d misses\n", $stats['entries'], $stats['bytes'], $stats['hits'], $stats['misses']);
@@ -0,0 +1,40 @@
+<?php
+// Small calls whose scratch buffers now come from the per-request arena or
+// the stack instead of emalloc()/efree() pairs. Compare against a build
+// before the change; memory_get_usage() should not move between iterations.
+//
+// Usage: php -d extension=h3.so benchmarks/scratch.php [iterations]
+
+$iterations = (int) ($argv[1] ?? 200000);
+
+$index = new \H3\H3Index(0x8928308280fffff);
+$other = new \H3\H3Index(0x8928308287bffff);
+$edge = $index->getDirectedEdges()[0];
+$latLng = $index->toGeo();
+
+$benchmarks = [
+    'toGeo' => fn () => $index->toGeo(),
+    'toGeoBoundary' => fn () => $index->toGeoBoundary(),
+    'fromGeo' => fn () => \H3\H3Index::fromGeo($latLng, 9),
+    'kRing(1)' => fn () => $index->kRing(1),
+    'kRingDistances(2)' => fn () => $index->kRingDistances(2),
+    'toChildren(+1)' => fn () => $index->toChildren(10),
+    'getDirectedEdges' => fn () => $index->getDirectedEdges(),
+    'edge getIndexes' => fn () => $edge->getIndexes(),
+    'line' => fn () => \H3\line($index, $other),
+];
+
+printf("%-24s %12s %12s\n", 'benchmark', 'ns/call', 'mem delta');
+
+foreach ($benchmarks as $name => $benchmark) {
+    $benchmark();
+    $memory = memory_get_usage();
+
+    $start = hrtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $benchmark();
+    }
+    $ns = (hrtime(true) - $start) / $iterations;
+
+    printf("%-24s %12.1f %12d\n", $name, $ns, memory_get_usage() - $memory);
+}
@@ -0,0 +1,37 @@
+<?php
+// Scaling of the threaded polyfill() and compact() paths with h3.threads.
+// The setting is system-wide, so run once per thread count:
+//
+// Usage: for t in 1 2 4 8; do php -d extension=h3.so -d h3.threads=$t benchmarks/threads.php [iterations]; done
+
+$iterations = (int) ($argv[1] ?? 5);
+
+// San Francisco peninsula at res 11 and 12
+$polygon = \H3\GeoPolygon::fromGeoJson([[
+    [-122.5149, 37.7081], [-122.3569, 37.7081], [-122.3569, 37.8324],
+    [-122.4794, 37.8110], [-122.5149, 37.7790], [-122.5149, 37.7081],
+]]);
+
+// every res 9 child of a res 3 cell, in descending order so that compact()
+// skips its streaming path for sorted input
+$compactSet = array_reverse(\H3\H3Index::fromLong(0x832830fffffffff)->toChildren(9));
+
+$benchmarks = [
+    'polyfill res 11' => fn () => \H3\polyfill($polygon, 11),
+    'polyfill res 12' => fn () => \H3\polyfill($polygon, 12),
+    'compact ' . count($compactSet) . ' cells' => fn () => \H3\compact($compactSet),
+];
+
+printf("%-24s %8s %12s\n", 'benchmark', 'threads', 'ms');
+
+foreach ($benchmarks as $name => $benchmark) {
+    $benchmark();
+
+    $start = hrtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $benchmark();
+    }
+    $ms = (hrtime(true) - $start) / 1e6 / $iterations;
+
+    printf("%-24s %8s %12.2f\n", $name, ini_get('h3.threads'), $ms);
+}
@@ -41,6 +41,8 @@ if test "$PHP_H3" != "no"; then
     -L$LIBH3_DIR/$PHP_LIBDIR -lm
   ])
 
+  PHP_ADD_LIBRARY(pthread, 1, H3_SHARED_LIBADD)
+
   PHP_NEW_EXTENSION(h3, h3.c, $ext_shared)
   PHP_SUBST(H3_SHARED_LIBADD)
 fi
@@ -4,13 +4,20 @@
 #include "config.h"
 #endif
 
+#include "ext/json/php_json.h"
 #include "ext/spl/spl_exceptions.h"
 #include "ext/standard/info.h"
 #include "h3_arginfo.h"
 #include "php.h"
 #include "php_h3.h"
 #include "zend_exceptions.h"
+#include "zend_smart_str.h"
 #include <h3/h3api.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 ZEND_DECLARE_MODULE_GLOBALS(h3)
 
@@ -20,6 +27,44 @@ ZEND_DECLARE_MODULE_GLOBALS(h3)
 #define H3_EDGE_NUM_INDX 2
 #define H3_MIN_RES 0
 #define H3_MAX_RES 15
+#define H3_STREAM_CHUNK_SIZE 8192
+#define H3_MAX_THREADS 256
+#define H3_PARALLEL_MIN_CELLS 16384
+#define H3_PARALLEL_TASKS_PER_THREAD 4
+#define H3_PARALLEL_MAX_NEIGHBORS 36
+#define H3_MAX_DISK_K 1000
+#define H3_NUM_BASE_CELLS_BITS 128
+#define H3_BAND_EPSILON 1e-9
+#define H3_SCRATCH_BLOCK_SIZE 4096
+#define H3_SCRATCH_MAX_RETAINED (1024 * 1024)
+#define H3_BUDGET_BANDS 16
+#define H3_BUDGET_OVERFILL 49
+#define H3_CACHE_KEY_PARALLEL UINT32_C(0x80000000)
+
+#define H3_GET_RES(h) ((int) (((h) >> 52) & 0xf))
+#define H3_GET_BASE_CELL(h) ((int) (((h) >> 45) & 0x7f))
+#define H3_DIGITS_MASK ((UINT64_C(1) << 45) - 1)
+#define H3_PENTAGON_BASE_CELLS_LO UINT64_C(0x8402004001004010)
+#define H3_PENTAGON_BASE_CELLS_HI UINT64_C(0x0020080200080100)
+#define H3_IS_PENTAGON_BASE_CELL(b) \
+    ((((b) < 64 ? H3_PENTAGON_BASE_CELLS_LO >> (b) : H3_PENTAGON_BASE_CELLS_HI >> ((b) - 64))) & 1)
+#define H3_DIGIT_LOW_BITS UINT64_C(0x49249249249)
+#define H3_RES_MASK (UINT64_C(0xf) << 52)
+#define H3_DIGITS_BELOW(res) ((UINT64_C(1) << ((H3_MAX_RES - (res)) * 3)) - 1)
+#define H3_NUM_BASE_CELLS 122
+#define H3_NUM_PENTAGONS 12
+#define H3_CELL_MODE 1
+#define H3_DIRECTED_EDGE_MODE 2
+
+#ifdef WORDS_BIGENDIAN
+#define H3_WKB_BYTE_ORDER 0
+#else
+#define H3_WKB_BYTE_ORDER 1
+#endif
+#define H3_WKB_POLYGON 3
+#define H3_WKB_MULTI_POLYGON 6
+#define H3_EWKB_SRID_FLAG 0x20000000
+#define H3_EWKB_SRID 4326
 
 #define H3_AREA_UNIT_KM2 0
 #define H3_AREA_UNIT_M2 1
@@ -29,6 +74,35 @@ ZEND_DECLARE_MODULE_GLOBALS(h3)
 #define H3_LENGTH_UNIT_M 1
 #define H3_LENGTH_UNIT_RADS 2
 
+#define H3_DISTANCES_NESTED 0
+#define H3_DISTANCES_MAP 1
+#define H3_DISTANCES_PACKED 2
+
+#define H3_OUTPUT_LIST 0
+#define H3_OUTPUT_SET 1
+#define H3_OUTPUT_MAP 2
+
+#define H3_ORDER_INDEX 0
+#define H3_ORDER_MORTON 1
+#define H3_ORDER_HILBERT 2
+#define H3_CURVE_BITS 31
+
+#define H3_SET_UNION 0
+#define H3_SET_INTERSECTION 1
+#define H3_SET_DIFFERENCE 2
+
+#define VALIDATE_H3_ORDER(order, arg_num)                                                                          \
+    if (order != H3_ORDER_INDEX && order != H3_ORDER_MORTON && order != H3_ORDER_HILBERT) {                        \
+        zend_argument_value_error(arg_num, "must be one of H3_ORDER_INDEX, H3_ORDER_MORTON, or H3_ORDER_HILBERT"); \
+        RETURN_THROWS();                                                                                           \
+    }
+
+#define VALIDATE_H3_OUTPUT(output, arg_num)                                                                    \
+    if (output != H3_OUTPUT_LIST && output != H3_OUTPUT_SET && output != H3_OUTPUT_MAP) {                     \
+        zend_argument_value_error(arg_num, "must be one of H3_OUTPUT_LIST, H3_OUTPUT_SET, or H3_OUTPUT_MAP"); \
+        RETURN_THROWS();                                                                                       \
+    }
+
 #define H3_ERR_CODE_INVALID_RES 1
 #define H3_ERR_CODE_INVALID_INDEX 2
 #define H3_ERR_CODE_UNSUPPORTED_UNIT 3
@@ -61,6 +135,136 @@ ZEND_DECLARE_MODULE_GLOBALS(h3)
 
 typedef H3Index H3DirectedEdge;
 
+typedef struct {
+    smart_str buf;
+    php_stream *stream;
+    size_t written;
+} h3_writer;
+
+typedef struct {
+    double north;
+    double south;
+    double east;
+    double west;
+} h3_bbox;
+
+typedef struct {
+    LatLng coord;
+    bool cached;
+    uint32_t epoch;
+    zend_object std;
+} h3_lat_lng_object;
+
+typedef struct {
+    GeoLoop loop;
+    bool cached;
+    uint32_t epoch;
+    zend_object std;
+} h3_cell_boundary_object;
+
+typedef struct {
+    GeoPolygon polygon;
+    h3_bbox bbox;
+    bool cached;
+    uint32_t epoch;
+    zend_object std;
+} h3_geo_polygon_object;
+
+typedef void (*h3_task_fn)(void *task);
+
+typedef struct {
+    h3_task_fn fn;
+    char *tasks;
+    size_t task_size;
+    size_t num_tasks;
+    size_t next;
+    pthread_mutex_t lock;
+} h3_pool;
+
+typedef struct {
+    const GeoPolygon *polygon;
+    int res;
+    double south;
+    double north;
+    double min_center_lat;
+    double max_center_lat;
+    H3Index *cells;
+    int64_t num_cells;
+    H3Error err;
+} h3_polyfill_task;
+
+typedef struct {
+    const H3Index *cells;
+    H3Index *out;
+    int64_t num_cells;
+    H3Error err;
+} h3_compact_task;
+
+typedef struct {
+    const H3Index *cells;
+    const int64_t *table;
+    uint64_t mask;
+    int k;
+    int64_t disk_size;
+    H3Index *disk;
+    int *disk_distances;
+    int32_t *neighbors;
+    int *distances;
+    int64_t start;
+    int64_t end;
+} h3_neighbors_task;
+
+typedef struct {
+    const H3Index *cells;
+    int64_t num_cells;
+    LinkedGeoPolygon *out;
+    H3Error err;
+} h3_outline_task;
+
+typedef struct {
+    H3Index *slots;
+    uint64_t mask;
+    int64_t count;
+    uint32_t resolutions;
+} h3_cell_set;
+
+typedef struct {
+    H3Index *cells;
+    int64_t count;
+    int64_t size;
+} h3_cell_list;
+
+typedef struct _h3_scratch_block {
+    struct _h3_scratch_block *prev;
+    size_t size;
+    size_t used;
+    char data[];
+} h3_scratch_block;
+
+typedef struct {
+    h3_scratch_block *block;
+    size_t used;
+} h3_scratch_mark;
+
+typedef struct {
+    double hex_area_km2;
+    double hex_area_m2;
+    double edge_length_km;
+    double edge_length_m;
+    int64_t num_cells;
+    H3Index pentagons[H3_NUM_PENTAGONS];
+} h3_res_table;
+
+typedef struct {
+    zend_string *key;
+    size_t size;
+    int64_t count;
+    H3Index cells[];
+} h3_result_cache_entry;
+
+#define H3_OBJ(type, obj) ((type *) ((char *) (obj) - XtOffsetOf(type, std)))
+#define H3_GEOMETRY_CACHE_VALID(intern) ((intern)->cached && (intern)->epoch == H3_G(geometry_epoch))
+
 zend_class_entry *H3_H3Exception_ce;
 zend_class_entry *H3_H3Index_ce;
 zend_class_entry *H3_H3DirectedEdge_ce;
@@ -70,11 +274,112 @@ zend_class_entry *H3_GeoPolygon_ce;
 zend_class_entry *H3_GeoMultiPolygon_ce;
 zend_class_entry *H3_CoordIJ_ce;
 
+zend_object_handlers h3_lat_lng_handlers;
+zend_object_handlers h3_cell_boundary_handlers;
+zend_object_handlers h3_geo_polygon_handlers;
+
+// Filled once in MINIT, read only afterwards
+H3Index h3_res0_cells[H3_NUM_BASE_CELLS];
+h3_res_table h3_res_tables[H3_MAX_RES + 1];
+
 int max_hex_kring_size(int k)
 {
     return k == 0 ? 1 : k * H3_HEX_NUM_EDGES;
 }
 
+h3_scratch_block *h3_scratch_block_new(size_t size, h3_scratch_block *prev)
+{
+    h3_scratch_block *block = emalloc(sizeof(h3_scratch_block) + size);
+
+    block->prev = prev;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+// Scratch buffers are bump allocated from a per-request arena. Callers save a
+// mark before allocating and restore it on every return path.
+h3_scratch_mark h3_scratch_save(void)
+{
+    h3_scratch_mark mark = {H3_G(scratch), H3_G(scratch) ? H3_G(scratch)->used : 0};
+
+    return mark;
+}
+
+void *h3_scratch_alloc(size_t count, size_t size)
+{
+    h3_scratch_block *block = H3_G(scratch);
+    size_t len = ZEND_MM_ALIGNED_SIZE(zend_safe_address_guarded(count, size, 0));
+    size_t total;
+    void *out;
+
+    if (!block || block->size - block->used < len) {
+        block = h3_scratch_block_new(MAX(len, block ? block->size * 2 : H3_SCRATCH_BLOCK_SIZE), block);
+        H3_G(scratch) = block;
+
+        total = 0;
+        for (h3_scratch_block *b = block; b; b = b->prev) {
+            total += b->size;
+        }
+        H3_G(scratch_peak) = MAX(H3_G(scratch_peak), total);
+    }
+
+    out = block->data + block->used;
+    block->used += len;
+
+    return out;
+}
+
+void *h3_scratch_calloc(size_t count, size_t size)
+{
+    void *out = h3_scratch_alloc(count, size);
+
+    memset(out, 0, count * size);
+
+    return out;
+}
+
+void h3_scratch_restore(h3_scratch_mark mark)
+{
+    h3_scratch_block *block = H3_G(scratch);
+
+    while (block != mark.block) {
+        h3_scratch_block *prev = block->prev;
+
+        efree(block);
+        block = prev;
+    }
+
+    if (block) {
+        block->used = mark.used;
+    }
+
+    // Emptied after growing: replace the first block by one as large as the
+    // peak, so calls of the same size are served without growing again
+    if (mark.used == 0 && (!block || !block->prev)) {
+        if (H3_G(scratch_peak) > (block ? block->size : 0) && H3_G(scratch_peak) <= H3_SCRATCH_MAX_RETAINED) {
+            if (block) {
+                efree(block);
+            }
+            block = h3_scratch_block_new(H3_G(scratch_peak), NULL);
+        }
+        H3_G(scratch_peak) = block ? block->size : 0;
+    }
+
+    H3_G(scratch) = block;
+}
+
+void h3_scratch_free(void)
+{
+    while (H3_G(scratch)) {
+        h3_scratch_block *prev = H3_G(scratch)->prev;
+
+        efree(H3_G(scratch));
+        H3_G(scratch) = prev;
+    }
+}
+
 H3Index obj_to_h3(zend_object *obj)
 {
     zval *prop;
@@ -103,6 +408,35 @@ void h3_array_to_zend_array(H3Index *in, int64_t size, zval *out)
     }
 }
 
+// Appends cells to out as H3Index objects, or keyed by index with true or the
+// H3Index object as the value, growing the hash once up front.
+void h3_array_add_to_zval(H3Index *in, int64_t size, zend_long output, zval *out)
+{
+    int64_t count = 0;
+
+    if (output == H3_OUTPUT_LIST) {
+        h3_array_to_zend_array(in, size, out);
+        return;
+    }
+
+    for (int64_t i = 0; i < size; i++) {
+        count += in[i] != H3_INVALID_INDEX;
+    }
+
+    zend_hash_extend(Z_ARRVAL_P(out), zend_hash_num_elements(Z_ARRVAL_P(out)) + count, 0);
+
+    for (int64_t i = 0; i < size; i++) {
+        if (in[i] == H3_INVALID_INDEX) {
+            continue;
+        }
+        if (output == H3_OUTPUT_SET) {
+            add_index_bool(out, in[i], 1);
+        } else {
+            add_index_object(out, in[i], h3_to_obj(in[i]));
+        }
+    }
+}
+
 int zend_array_to_h3_array(zend_array *arr, H3Index *out)
 {
     int idx = 0;
@@ -121,844 +455,5551 @@ int zend_array_to_h3_array(zend_array *arr, H3Index *out)
     return 0;
 }
 
-H3DirectedEdge obj_to_h3de(zend_object *obj)
+int zval_to_h3(zval *val, H3Index *out)
 {
-    zval *prop;
-    zval rv;
+    if (OBJ_IS_A(val, H3_H3Index_ce)) {
+        *out = obj_to_h3(Z_OBJ_P(val));
+        return 0;
+    }
 
-    prop = zend_read_property(H3_H3DirectedEdge_ce, obj, "index", sizeof("index") - 1, 1, &rv);
+    if (Z_TYPE_P(val) == IS_LONG) {
+        *out = Z_LVAL_P(val);
+        return 0;
+    }
 
-    return zval_get_long(prop);
+    return -1;
 }
 
-zend_object *h3de_to_obj(H3DirectedEdge index)
+H3Index *h3_buffer_from_array_or_str(zend_array *arr, zend_string *str, size_t *count)
 {
-    zend_object *obj = zend_objects_new(H3_H3DirectedEdge_ce);
-    object_properties_init(obj, H3_H3DirectedEdge_ce);
-    zend_update_property_long(H3_H3DirectedEdge_ce, obj, "index", sizeof("index") - 1, index);
+    H3Index *out;
+    zval *val;
+    size_t idx = 0;
 
-    return obj;
-}
+    if (str) {
+        if (ZSTR_LEN(str) % sizeof(H3Index) != 0) {
+            return NULL;
+        }
 
-void h3de_array_to_zend_array(H3DirectedEdge *in, int size, zval *out)
-{
-    for (int i = 0; i < size; i++) {
-        if (in[i] != H3_INVALID_INDEX) {
-            add_next_index_object(out, h3de_to_obj(in[i]));
+        *count = ZSTR_LEN(str) / sizeof(H3Index);
+        out = safe_emalloc(*count, sizeof(H3Index), 0);
+        memcpy(out, ZSTR_VAL(str), ZSTR_LEN(str));
+
+        return out;
+    }
+
+    *count = zend_array_count(arr);
+    out = safe_emalloc(*count, sizeof(H3Index), 0);
+
+    ZEND_HASH_FOREACH_VAL(arr, val)
+    {
+        if (zval_to_h3(val, &out[idx++]) != 0) {
+            efree(out);
+            return NULL;
         }
     }
+    ZEND_HASH_FOREACH_END();
+
+    return out;
 }
 
-void obj_to_geo(zend_object *obj, LatLng *geo)
+void doubles_to_array(const double *values, size_t count, zval *out)
 {
-    zval *prop;
-    zval rv;
+    array_init_size(out, count);
+    zend_hash_real_init_packed(Z_ARRVAL_P(out));
 
-    prop = zend_read_property(H3_LatLng_ce, obj, "lat", sizeof("lat") - 1, 1, &rv);
-    geo->lat = degsToRads(zval_get_double(prop));
-    prop = zend_read_property(H3_LatLng_ce, obj, "lon", sizeof("lon") - 1, 1, &rv);
-    geo->lng = degsToRads(zval_get_double(prop));
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(out))
+    {
+        for (size_t i = 0; i < count; i++) {
+            ZEND_HASH_FILL_SET_DOUBLE(values[i]);
+            ZEND_HASH_FILL_NEXT();
+        }
+    }
+    ZEND_HASH_FILL_END();
 }
 
-zend_object *geo_to_obj(LatLng *geo)
+void uint32s_to_array(const uint32_t *values, size_t count, zval *out)
 {
-    zend_object *obj = zend_objects_new(H3_LatLng_ce);
-    object_properties_init(obj, H3_LatLng_ce);
-
-    zend_update_property_double(H3_LatLng_ce, obj, "lat", sizeof("lat") - 1, radsToDegs(geo->lat));
-    zend_update_property_double(H3_LatLng_ce, obj, "lon", sizeof("lon") - 1, radsToDegs(geo->lng));
+    array_init_size(out, count);
+    zend_hash_real_init_packed(Z_ARRVAL_P(out));
 
-    return obj;
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(out))
+    {
+        for (size_t i = 0; i < count; i++) {
+            ZEND_HASH_FILL_SET_LONG(values[i]);
+            ZEND_HASH_FILL_NEXT();
+        }
+    }
+    ZEND_HASH_FILL_END();
 }
 
-zend_object *geo_boundary_to_obj(CellBoundary *boundary)
+void indexes_to_array(const H3Index *values, size_t count, zval *out)
 {
-    zval val;
-    array_init_size(&val, boundary->numVerts);
+    array_init_size(out, count);
+    zend_hash_real_init_packed(Z_ARRVAL_P(out));
 
-    for (int i = 0; i < boundary->numVerts; i++) {
-        add_next_index_object(&val, geo_to_obj(&boundary->verts[i]));
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(out))
+    {
+        for (size_t i = 0; i < count; i++) {
+            ZEND_HASH_FILL_SET_LONG(values[i]);
+            ZEND_HASH_FILL_NEXT();
+        }
     }
+    ZEND_HASH_FILL_END();
+}
 
-    zend_object *obj = zend_objects_new(H3_CellBoundary_ce);
-    object_properties_init(obj, H3_CellBoundary_ce);
+// Hex digit values plus one, so that zero marks any other character
+const uint8_t h3_hex_values[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8,
+    ['8'] = 9, ['9'] = 10, ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
 
-    zend_update_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, &val);
+const char h3_hex_digits[] = "0123456789abcdef";
 
-    zval_ptr_dtor(&val);
+// Length of the lowercase hex form without leading zeros, as h3ToString()
+// writes it
+int h3_hex_len(H3Index index)
+{
+    return index ? 16 - __builtin_clzll(index) / 4 : 1;
+}
 
-    return obj;
+void h3_to_hex(H3Index index, char *out, int len)
+{
+    for (int i = len - 1; i >= 0; i--) {
+        out[i] = h3_hex_digits[index & 0xf];
+        index >>= 4;
+    }
 }
 
-int zend_array_to_geocoord_array(zend_array *arr, LatLng *out)
+zend_string *h3_to_zend_string(H3Index index)
 {
-    int idx = 0;
-    zval *val;
+    int len = h3_hex_len(index);
+    zend_string *out = zend_string_alloc(len, 0);
 
-    ZEND_HASH_FOREACH_VAL(arr, val)
-    {
-        if (OBJ_IS_A(val, H3_LatLng_ce)) {
-            obj_to_geo(Z_OBJ_P(val), &out[idx++]);
-        } else {
-            return -1;
-        }
-    }
-    ZEND_HASH_FOREACH_END();
+    h3_to_hex(index, ZSTR_VAL(out), len);
+    ZSTR_VAL(out)[len] = '\0';
 
-    return 0;
+    return out;
 }
 
-int obj_to_geoloop(zend_object *obj, GeoLoop *out)
+// Parses 1 to 16 hex digits and nothing else
+bool hex_to_h3(const char *str, size_t len, H3Index *out)
 {
-    zval *prop;
-    zval rv;
-    zend_array *arr;
-    int idx = 0;
-    zval *val;
+    H3Index index = 0;
 
-    prop = zend_read_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, 1, &rv);
-    arr = Z_ARR_P(prop);
+    if (len == 0 || len > 16) {
+        return false;
+    }
 
-    uint32_t num_verts = zend_array_count(arr);
-    LatLng *verts = ecalloc(num_verts, sizeof(LatLng));
+    for (size_t i = 0; i < len; i++) {
+        uint8_t value = h3_hex_values[(unsigned char) str[i]];
 
-    ZEND_HASH_FOREACH_VAL(arr, val)
-    {
-        if (OBJ_IS_A(val, H3_LatLng_ce)) {
-            obj_to_geo(Z_OBJ_P(val), &verts[idx++]);
-        } else {
-            efree(verts);
-            return -1;
+        if (!value) {
+            return false;
         }
+        index = (index << 4) | (value - 1);
     }
-    ZEND_HASH_FOREACH_END();
 
-    out->numVerts = num_verts;
-    out->verts = verts;
+    *out = index;
 
-    efree(verts);
+    return true;
+}
 
-    return 0;
+// Plain hex is parsed directly. Anything else goes through stringToH3(),
+// which also accepts surrounding whitespace and a 0x prefix.
+H3Error zend_string_to_h3(zend_string *str, H3Index *out)
+{
+    return hex_to_h3(ZSTR_VAL(str), ZSTR_LEN(str), out) ? E_SUCCESS : stringToH3(ZSTR_VAL(str), out);
 }
 
-int zend_array_to_geoloop_array(zend_array *arr, GeoLoop *out)
+void uint8s_to_array(const uint8_t *values, size_t count, zval *out)
 {
-    int idx = 0;
-    zval *val;
-    GeoLoop tmp;
+    array_init_size(out, count);
+    zend_hash_real_init_packed(Z_ARRVAL_P(out));
 
-    ZEND_HASH_FOREACH_VAL(arr, val)
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(out))
     {
-        if (OBJ_IS_A(val, H3_CellBoundary_ce) && obj_to_geoloop(Z_OBJ_P(val), &tmp) == 0) {
-            out[idx++] = tmp;
-        } else {
-            return -1;
+        for (size_t i = 0; i < count; i++) {
+            ZEND_HASH_FILL_SET_LONG(values[i]);
+            ZEND_HASH_FILL_NEXT();
         }
     }
-    ZEND_HASH_FOREACH_END();
-
-    return 0;
+    ZEND_HASH_FILL_END();
 }
 
-void h3_line(zend_object *start, zend_object *end, INTERNAL_FUNCTION_PARAMETERS)
+// Reads resolution, base cell, pentagon and class III flags straight from the
+// index bits. A pentagon is a cell on a pentagon base cell whose digits are
+// all zero.
+void cells_decode(const H3Index *cells, size_t count, uint8_t *resolutions, uint8_t *base_cells, uint8_t *pentagons, uint8_t *class_iii)
 {
-    H3Index startIndex = obj_to_h3(start);
-    H3Index endIndex = obj_to_h3(end);
+    for (size_t i = 0; i < count; i++) {
+        int res = H3_GET_RES(cells[i]);
+        int base_cell = H3_GET_BASE_CELL(cells[i]);
+
+        resolutions[i] = res;
+        base_cells[i] = base_cell;
+        class_iii[i] = res & 1;
+        pentagons[i] = H3_IS_PENTAGON_BASE_CELL(base_cell) && ((cells[i] & H3_DIGITS_MASK) >> (3 * (H3_MAX_RES - res))) == 0;
+    }
+}
 
-    int64_t size;
-    H3Error err = gridPathCellsSize(startIndex, endIndex, &size);
+// Mirrors isValidCell() and isValidDirectedEdge() with plain bit tests that
+// do not stop at the first failure. Edges carry their direction in the
+// reserved bits and are checked through their origin.
+int h3_index_is_invalid(uint64_t h, uint64_t mode)
+{
+    int res = H3_GET_RES(h);
+    int base_cell = H3_GET_BASE_CELL(h);
+    uint64_t reserved = (h >> 56) & 7;
+    uint64_t unused = (UINT64_C(1) << (3 * (H3_MAX_RES - res))) - 1;
+    uint64_t digits = h & H3_DIGITS_MASK & ~unused;
+    uint64_t sevens = digits & (digits >> 1) & (digits >> 2) & H3_DIGIT_LOW_BITS;
+    uint64_t pentagon = H3_IS_PENTAGON_BASE_CELL(base_cell);
+    int invalid = (h >> 63) | (((h >> 59) & 15) != mode) | (base_cell >= H3_NUM_BASE_CELLS) | ((h & unused) != unused)
+        | (sevens != 0);
+
+    // a pentagon's first non-zero digit may not be 1, the deleted k-axes
+    // subsequence. Only 12 of the 122 base cells need this.
+    if (pentagon && digits) {
+        int shift = 42;
+        while ((digits >> shift) == 0) {
+            shift -= 3;
+        }
+        invalid |= (digits >> shift) == 1;
+    }
 
-    if (err) {
-        H3_THROW("Failed to calculate line size", H3_ERR_CODE_LINE_SIZE_ERROR);
-        RETURN_THROWS();
+    if (mode == H3_CELL_MODE) {
+        return invalid | (reserved != 0);
     }
 
-    H3Index *out = ecalloc(size, sizeof(H3Index));
-    err = gridPathCells(startIndex, endIndex, out);
+    return invalid | (reserved == 0) | (reserved == 7) | (pentagon & (digits == 0) & (reserved == 1));
+}
 
-    if (err) {
-        H3_THROW("Failed to calculate line", H3_ERR_CODE_LINE_SIZE_ERROR);
-        efree(out);
-        RETURN_THROWS();
+#ifdef __AVX2__
+// Four lanes of h3_index_is_invalid() at a time, returning one bit per lane.
+int h3_indexes_are_invalid_avx2(const H3Index *indexes, uint64_t mode)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i seven = _mm256_set1_epi64x(7);
+    const __m256i h = _mm256_loadu_si256((const __m256i *) indexes);
+    __m256i res = _mm256_and_si256(_mm256_srli_epi64(h, 52), _mm256_set1_epi64x(15));
+    __m256i base_cell = _mm256_and_si256(_mm256_srli_epi64(h, 45), _mm256_set1_epi64x(0x7f));
+    __m256i reserved = _mm256_and_si256(_mm256_srli_epi64(h, 56), seven);
+    __m256i unused_digits = _mm256_sub_epi64(_mm256_set1_epi64x(H3_MAX_RES), res);
+    __m256i unused = _mm256_sub_epi64(_mm256_sllv_epi64(one, _mm256_add_epi64(unused_digits, _mm256_slli_epi64(unused_digits, 1))), one);
+    __m256i digits = _mm256_andnot_si256(unused, _mm256_and_si256(h, _mm256_set1_epi64x(H3_DIGITS_MASK)));
+    __m256i sevens = _mm256_and_si256(_mm256_and_si256(digits, _mm256_srli_epi64(digits, 1)),
+        _mm256_and_si256(_mm256_srli_epi64(digits, 2), _mm256_set1_epi64x(H3_DIGIT_LOW_BITS)));
+    // out of range shift counts give zero, so each half only answers for its own base cells
+    __m256i pentagon = _mm256_and_si256(
+        _mm256_or_si256(_mm256_srlv_epi64(_mm256_set1_epi64x(H3_PENTAGON_BASE_CELLS_LO), base_cell),
+            _mm256_srlv_epi64(_mm256_set1_epi64x(H3_PENTAGON_BASE_CELLS_HI), _mm256_sub_epi64(base_cell, _mm256_set1_epi64x(64)))),
+        one);
+    __m256i leading_one = zero;
+    __m256i invalid;
+
+    pentagon = _mm256_cmpeq_epi64(pentagon, one);
+
+    for (int i = 0; i < H3_MAX_RES; i++) {
+        leading_one = _mm256_or_si256(leading_one, _mm256_cmpeq_epi64(_mm256_srlv_epi64(digits, _mm256_set1_epi64x(3 * i)), one));
     }
 
-    array_init(return_value);
-    h3_array_to_zend_array(out, size, return_value);
+    invalid = _mm256_or_si256(_mm256_cmpgt_epi64(zero, h),
+        _mm256_xor_si256(_mm256_cmpeq_epi64(_mm256_srli_epi64(h, 59), _mm256_set1_epi64x(mode)), _mm256_set1_epi64x(-1)));
+    invalid = _mm256_or_si256(invalid, _mm256_cmpgt_epi64(base_cell, _mm256_set1_epi64x(H3_NUM_BASE_CELLS - 1)));
+    invalid = _mm256_or_si256(invalid, _mm256_xor_si256(_mm256_cmpeq_epi64(_mm256_and_si256(h, unused), unused), _mm256_set1_epi64x(-1)));
+    invalid = _mm256_or_si256(invalid, _mm256_xor_si256(_mm256_cmpeq_epi64(sevens, zero), _mm256_set1_epi64x(-1)));
+    invalid = _mm256_or_si256(invalid, _mm256_and_si256(pentagon, leading_one));
 
-    efree(out);
+    if (mode == H3_CELL_MODE) {
+        invalid = _mm256_or_si256(invalid, _mm256_xor_si256(_mm256_cmpeq_epi64(reserved, zero), _mm256_set1_epi64x(-1)));
+    } else {
+        invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi64(reserved, zero));
+        invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi64(reserved, seven));
+        invalid = _mm256_or_si256(invalid,
+            _mm256_and_si256(pentagon, _mm256_and_si256(_mm256_cmpeq_epi64(digits, zero), _mm256_cmpeq_epi64(reserved, one))));
+    }
+
+    return _mm256_movemask_pd(_mm256_castsi256_pd(invalid));
 }
+#endif
 
-int geofence_obj_to_geojson_arr(zend_object *geofence_obj, zval *geojson_geofence_val)
+// Sets bit i of bitmap, least significant bit first, for every entry that is
+// not a valid index of the given mode, and returns how many there were.
+size_t indexes_validate(const H3Index *indexes, size_t count, uint64_t mode, uint8_t *bitmap)
 {
-    zval *prop;
-    zval rv;
-    zend_array *geofence_verts_arr;
-    zval *geofence_vert_val;
-    zend_object *coord_obj;
-    zval coords_val;
-    zval first_coords_val;
-    int idx = 0;
-    uint32_t verts_count;
+    size_t num_invalid = 0;
+    size_t i = 0;
+    int invalid;
 
-    prop = zend_read_property(H3_CellBoundary_ce, geofence_obj, "vertices", sizeof("vertices") - 1, 1, &rv);
-    geofence_verts_arr = Z_ARRVAL_P(prop);
-    verts_count = zend_array_count(geofence_verts_arr);
+    memset(bitmap, 0, (count + 7) / 8);
 
-    if (verts_count == 0) {
-        return -1;
+#ifdef __AVX2__
+    for (; i + 4 <= count; i += 4) {
+        invalid = h3_indexes_are_invalid_avx2(&indexes[i], mode);
+        bitmap[i / 8] |= invalid << (i % 8);
+        num_invalid += (invalid & 1) + ((invalid >> 1) & 1) + ((invalid >> 2) & 1) + ((invalid >> 3) & 1);
     }
+#endif
 
-    array_init_size(geojson_geofence_val, 1 + verts_count);
-
-    ZEND_HASH_FOREACH_VAL(geofence_verts_arr, geofence_vert_val)
-    {
-        if (Z_TYPE_P(geofence_vert_val) == IS_OBJECT && OBJ_IS_A(geofence_vert_val, H3_LatLng_ce)) {
-            coord_obj = Z_OBJ_P(geofence_vert_val);
-            array_init_size(&coords_val, 2);
-            prop = zend_read_property(H3_LatLng_ce, coord_obj, "lon", sizeof("lon") - 1, 1, &rv);
-            add_next_index_double(&coords_val, Z_DVAL_P(prop));
-            prop = zend_read_property(H3_LatLng_ce, coord_obj, "lat", sizeof("lat") - 1, 1, &rv);
-            add_next_index_double(&coords_val, Z_DVAL_P(prop));
-            add_next_index_zval(geojson_geofence_val, &coords_val);
-            if (idx++ == 0) {
-                ZVAL_COPY(&first_coords_val, &coords_val);
-            }
-        } else {
-            zval_ptr_dtor(geojson_geofence_val);
-            return -1;
-        }
+    for (; i < count; i++) {
+        invalid = h3_index_is_invalid(indexes[i], mode);
+        bitmap[i / 8] |= invalid << (i % 8);
+        num_invalid += invalid;
     }
-    ZEND_HASH_FOREACH_END();
-
-    add_next_index_zval(geojson_geofence_val, &first_coords_val);
 
-    return 0;
+    return num_invalid;
 }
 
-int multi_polygon_obj_to_geo_json(zend_object *obj, zval *return_value)
+// Whether every entry is a valid cell
+bool cells_are_valid(const H3Index *cells, size_t count)
 {
-    zval *prop;
-    zval rv;
-    zend_array *polygons_arr;
-    zval *val;
-    zend_object *polygon_obj;
-    zend_object *geofence_obj;
-    zend_array *holes_arr;
-    zval geojson_polygon_val;
-    zval coords_val;
-    zval *hole_val;
+    uint8_t *bits = emalloc((count + 7) / 8 + 1);
+    size_t num_invalid = indexes_validate(cells, count, H3_CELL_MODE, bits);
 
-    prop = zend_read_property(H3_GeoMultiPolygon_ce, obj, "polygons", sizeof("polygons") - 1, 1, &rv);
-    polygons_arr = Z_ARRVAL_P(prop);
+    efree(bits);
 
-    array_init_size(return_value, zend_array_count(polygons_arr));
+    return num_invalid == 0;
+}
 
-    ZEND_HASH_FOREACH_VAL(polygons_arr, val)
-    {
-        if (Z_TYPE_P(val) == IS_OBJECT && OBJ_IS_A(val, H3_GeoPolygon_ce)) {
-            polygon_obj = Z_OBJ_P(val);
+// The hierarchy kernels below only mask digit bits and keep their loops free
+// of branches so the compiler can vectorize them. Like cellToParent(), they
+// do not validate the input cells.
 
-            prop = zend_read_property(H3_GeoPolygon_ce, polygon_obj, "geofence", sizeof("geofence") - 1, 1, &rv);
-            geofence_obj = Z_OBJ_P(prop);
+// Returns nonzero when some cell is coarser than res.
+int cells_to_parents_masked(const H3Index *cells, size_t count, int res, H3Index *out)
+{
+    uint64_t below = H3_DIGITS_BELOW(res);
+    uint64_t keep = ~(H3_RES_MASK | below);
+    uint64_t set = ((uint64_t) res << 52) | below;
+    uint64_t coarser = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        coarser |= ((cells[i] >> 52) & 0xf) < (uint64_t) res;
+        out[i] = (cells[i] & keep) | set;
+    }
 
-            prop = zend_read_property(H3_GeoPolygon_ce, polygon_obj, "holes", sizeof("holes") - 1, 1, &rv);
-            holes_arr = Z_ARRVAL_P(prop);
+    return coarser != 0;
+}
 
-            array_init_size(&geojson_polygon_val, 1 + zend_array_count(holes_arr));
+// Returns nonzero when some cell is finer than res.
+int cells_to_center_children_masked(const H3Index *cells, size_t count, int res, H3Index *out)
+{
+    uint64_t below = H3_DIGITS_BELOW(res);
+    uint64_t finer = 0;
+    uint64_t cell_res;
+    uint64_t cleared;
+
+    for (size_t i = 0; i < count; i++) {
+        cell_res = (cells[i] >> 52) & 0xf;
+        finer |= cell_res > (uint64_t) res;
+        cleared = ((UINT64_C(1) << ((H3_MAX_RES - cell_res) * 3)) - 1) & ~below;
+        out[i] = (cells[i] & ~(H3_RES_MASK | cleared)) | ((uint64_t) res << 52);
+    }
 
-            if (geofence_obj_to_geojson_arr(geofence_obj, &coords_val) == 0) {
-                add_next_index_zval(&geojson_polygon_val, &coords_val);
-            } else {
-                zval_ptr_dtor(&geojson_polygon_val);
-                return -1;
+    return finer != 0;
+}
+
+// Sets bit i of bitmap, least significant bit first, when cells[i] is
+// ancestor or one of its descendants, and returns how many there were.
+size_t cells_descend_from(const H3Index *cells, size_t count, H3Index ancestor, uint8_t *bitmap)
+{
+    uint64_t res = H3_GET_RES(ancestor);
+    uint64_t prefix = ~(H3_RES_MASK | H3_DIGITS_BELOW(res));
+    size_t found = 0;
+    uint8_t byte;
+
+    for (size_t i = 0; i < count; i += 8) {
+        byte = 0;
+        for (size_t j = 0; j < 8 && i + j < count; j++) {
+            byte |= (uint8_t) ((((cells[i + j] ^ ancestor) & prefix) == 0 && ((cells[i + j] >> 52) & 0xf) >= res) << j);
+        }
+        bitmap[i / 8] = byte;
+        found += __builtin_popcount(byte);
+    }
+
+    return found;
+}
+
+uint64_t morton_spread(uint32_t value)
+{
+    uint64_t v = value;
+
+    v = (v | (v << 16)) & UINT64_C(0x0000ffff0000ffff);
+    v = (v | (v << 8)) & UINT64_C(0x00ff00ff00ff00ff);
+    v = (v | (v << 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    v = (v | (v << 2)) & UINT64_C(0x3333333333333333);
+    v = (v | (v << 1)) & UINT64_C(0x5555555555555555);
+
+    return v;
+}
+
+// Maps [min, max] onto H3_CURVE_BITS bits.
+uint32_t quantize_coord(double value, double min, double max)
+{
+    double scale = (double) (UINT32_C(1) << H3_CURVE_BITS);
+    double scaled = (value - min) / (max - min) * scale;
+
+    if (scaled <= 0) {
+        return 0;
+    }
+    if (scaled >= scale - 1) {
+        return (UINT32_C(1) << H3_CURVE_BITS) - 1;
+    }
+
+    return (uint32_t) scaled;
+}
+
+// Distance of (x, y) along the Hilbert curve filling the
+// 2^H3_CURVE_BITS square.
+uint64_t hilbert_index(uint32_t x, uint32_t y)
+{
+    uint64_t d = 0;
+    uint32_t rx, ry, t;
+
+    for (uint32_t s = UINT32_C(1) << (H3_CURVE_BITS - 1); s > 0; s >>= 1) {
+        rx = (x & s) != 0;
+        ry = (y & s) != 0;
+        d += (uint64_t) s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant; only the bits below s matter from here on
+        if (!ry) {
+            if (rx) {
+                x = ~x;
+                y = ~y;
             }
+            t = x;
+            x = y;
+            y = t;
+        }
+    }
 
-            ZEND_HASH_FOREACH_VAL(holes_arr, hole_val)
-            {
-                if (Z_TYPE_P(hole_val) == IS_OBJECT && OBJ_IS_A(hole_val, H3_CellBoundary_ce)) {
-                    if (geofence_obj_to_geojson_arr(Z_OBJ_P(hole_val), &coords_val) == 0) {
-                        add_next_index_zval(&geojson_polygon_val, &coords_val);
-                    } else {
-                        zval_ptr_dtor(&geojson_polygon_val);
-                        return -1;
-                    }
-                } else {
-                    zval_ptr_dtor(&geojson_polygon_val);
-                    return -1;
+    return d;
+}
+
+// Position of the cell center along a space-filling curve over longitude and
+// latitude. Keys use 2 * H3_CURVE_BITS bits, so they stay non-negative as
+// PHP integers.
+H3Error cell_to_curve_key(H3Index cell, zend_long order, uint64_t *key)
+{
+    LatLng center;
+    H3Error err = cellToLatLng(cell, &center);
+    uint32_t x, y;
+
+    if (err) {
+        return err;
+    }
+
+    x = quantize_coord(center.lng, -M_PI, M_PI);
+    y = quantize_coord(center.lat, -M_PI_2, M_PI_2);
+
+    if (order == H3_ORDER_HILBERT) {
+        *key = hilbert_index(x, y);
+    } else {
+        *key = morton_spread(x) | (morton_spread(y) << 1);
+    }
+
+    return E_SUCCESS;
+}
+
+H3Error cells_to_sort_keys(const H3Index *cells, size_t count, zend_long order, uint64_t *keys)
+{
+    H3Error err;
+
+    for (size_t i = 0; i < count; i++) {
+        if (order == H3_ORDER_INDEX) {
+            keys[i] = cells[i];
+        } else if ((err = cell_to_curve_key(cells[i], order, &keys[i]))) {
+            return err;
+        }
+    }
+
+    return E_SUCCESS;
+}
+
+// Stable LSD radix sort on bytes of keys, moving values (if any) along.
+// Bytes that are the same in every key, like the mode and resolution bits of
+// single resolution cells, are skipped.
+void radix_sort(uint64_t *keys, uint64_t *values, size_t count)
+{
+    size_t (*histograms)[256];
+    uint64_t *keys_tmp, *values_tmp = NULL, *swap;
+    size_t offset, pos, n;
+    int digit;
+
+    if (count < 2) {
+        return;
+    }
+
+    histograms = ecalloc(8, sizeof(*histograms));
+    for (size_t i = 0; i < count; i++) {
+        for (int b = 0; b < 8; b++) {
+            histograms[b][(keys[i] >> (b * 8)) & 0xff]++;
+        }
+    }
+
+    keys_tmp = safe_emalloc(count, sizeof(uint64_t), 0);
+    if (values) {
+        values_tmp = safe_emalloc(count, sizeof(uint64_t), 0);
+    }
+
+    uint64_t *keys_orig = keys;
+    uint64_t *values_orig = values;
+
+    for (int b = 0; b < 8; b++) {
+        if (histograms[b][(keys[0] >> (b * 8)) & 0xff] == count) {
+            continue;
+        }
+
+        offset = 0;
+        for (digit = 0; digit < 256; digit++) {
+            n = histograms[b][digit];
+            histograms[b][digit] = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            pos = histograms[b][(keys[i] >> (b * 8)) & 0xff]++;
+            keys_tmp[pos] = keys[i];
+            if (values) {
+                values_tmp[pos] = values[i];
+            }
+        }
+
+        swap = keys;
+        keys = keys_tmp;
+        keys_tmp = swap;
+        swap = values;
+        values = values_tmp;
+        values_tmp = swap;
+    }
+
+    if (keys != keys_orig) {
+        memcpy(keys_orig, keys, count * sizeof(uint64_t));
+        if (values) {
+            memcpy(values_orig, values, count * sizeof(uint64_t));
+        }
+        keys_tmp = keys;
+        values_tmp = values;
+    }
+
+    efree(keys_tmp);
+    if (values_tmp) {
+        efree(values_tmp);
+    }
+    efree(histograms);
+}
+
+// Sorts cells by the given order and, if unique, drops repeated cells.
+// Returns the number of cells kept.
+H3Error cells_sort(H3Index *cells, size_t count, zend_long order, bool unique, size_t *out_count)
+{
+    uint64_t *keys = NULL;
+    size_t kept = 0;
+    size_t run = 0;
+    H3Error err;
+
+    if (order != H3_ORDER_INDEX) {
+        keys = safe_emalloc(count, sizeof(uint64_t), 0);
+        err = cells_to_sort_keys(cells, count, order, keys);
+        if (err) {
+            efree(keys);
+            return err;
+        }
+        radix_sort(keys, cells, count);
+    } else {
+        radix_sort(cells, NULL, count);
+    }
+
+    if (!unique) {
+        *out_count = count;
+    } else {
+        // Equal cells share a key, but cells with equal keys need not be
+        // adjacent, so look back over the run of equal keys.
+        for (size_t i = 0; i < count; i++) {
+            if (kept > 0 && (keys ? keys[i] != keys[kept - 1] : cells[i] != cells[kept - 1])) {
+                run = kept;
+            }
+
+            size_t j = run;
+            while (j < kept && cells[j] != cells[i]) {
+                j++;
+            }
+            if (j == kept) {
+                if (keys) {
+                    keys[kept] = keys[i];
                 }
+                cells[kept++] = cells[i];
             }
-            ZEND_HASH_FOREACH_END();
+        }
+        *out_count = kept;
+    }
+
+    if (keys) {
+        efree(keys);
+    }
+
+    return E_SUCCESS;
+}
+
+H3Error cell_to_faces_mask(H3Index index, uint32_t *mask)
+{
+    int faces[5];
+    int max;
+    H3Error err = maxFaceCount(index, &max);
+
+    if (err) {
+        return err;
+    }
+
+    err = getIcosahedronFaces(index, faces);
+    if (err) {
+        return err;
+    }
+
+    *mask = 0;
+    for (int i = 0; i < max; i++) {
+        if (faces[i] >= 0) {
+            *mask |= UINT32_C(1) << faces[i];
+        }
+    }
+
+    return E_SUCCESS;
+}
+
+H3DirectedEdge obj_to_h3de(zend_object *obj)
+{
+    zval *prop;
+    zval rv;
+
+    prop = zend_read_property(H3_H3DirectedEdge_ce, obj, "index", sizeof("index") - 1, 1, &rv);
+
+    return zval_get_long(prop);
+}
+
+zend_object *h3de_to_obj(H3DirectedEdge index)
+{
+    zend_object *obj = zend_objects_new(H3_H3DirectedEdge_ce);
+    object_properties_init(obj, H3_H3DirectedEdge_ce);
+    zend_update_property_long(H3_H3DirectedEdge_ce, obj, "index", sizeof("index") - 1, index);
+
+    return obj;
+}
+
+void h3de_array_to_zend_array(H3DirectedEdge *in, int size, zval *out)
+{
+    for (int i = 0; i < size; i++) {
+        if (in[i] != H3_INVALID_INDEX) {
+            add_next_index_object(out, h3de_to_obj(in[i]));
+        }
+    }
+}
+
+void grid_distances_to_zval(const H3Index *cells, const int *distances, int64_t size, zend_long k, zend_long format, zval *out)
+{
+    int64_t count = 0;
+    zval cells_val;
+    zval distances_val;
+
+    for (int64_t i = 0; i < size; i++) {
+        count += cells[i] != H3_INVALID_INDEX;
+    }
+
+    if (format == H3_DISTANCES_MAP) {
+        array_init_size(out, count);
+        for (int64_t i = 0; i < size; i++) {
+            if (cells[i] != H3_INVALID_INDEX) {
+                add_index_long(out, cells[i], distances[i]);
+            }
+        }
+        return;
+    }
+
+    if (format == H3_DISTANCES_PACKED) {
+        array_init_size(&cells_val, count);
+        array_init_size(&distances_val, count);
+        zend_hash_real_init_packed(Z_ARRVAL(cells_val));
+        zend_hash_real_init_packed(Z_ARRVAL(distances_val));
+
+        ZEND_HASH_FILL_PACKED(Z_ARRVAL(cells_val))
+        {
+            for (int64_t i = 0; i < size; i++) {
+                if (cells[i] != H3_INVALID_INDEX) {
+                    ZEND_HASH_FILL_SET_LONG(cells[i]);
+                    ZEND_HASH_FILL_NEXT();
+                }
+            }
+        }
+        ZEND_HASH_FILL_END();
+
+        ZEND_HASH_FILL_PACKED(Z_ARRVAL(distances_val))
+        {
+            for (int64_t i = 0; i < size; i++) {
+                if (cells[i] != H3_INVALID_INDEX) {
+                    ZEND_HASH_FILL_SET_LONG(distances[i]);
+                    ZEND_HASH_FILL_NEXT();
+                }
+            }
+        }
+        ZEND_HASH_FILL_END();
+
+        array_init_size(out, 2);
+        add_assoc_zval(out, "cells", &cells_val);
+        add_assoc_zval(out, "distances", &distances_val);
+        return;
+    }
+
+    array_init_size(out, k + 1);
+    for (zend_long i = 0; i <= k; i++) {
+        array_init(&cells_val);
+        add_next_index_zval(out, &cells_val);
+    }
+
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_INVALID_INDEX) {
+            add_next_index_object(zend_hash_index_find(Z_ARRVAL_P(out), distances[i]), h3_to_obj(cells[i]));
+        }
+    }
+}
+
+void *h3_geometry_object_alloc(size_t size, zend_class_entry *ce)
+{
+    void *intern = zend_object_alloc(size, ce);
+    memset(intern, 0, size - sizeof(zend_object));
+
+    return intern;
+}
+
+zend_object *h3_lat_lng_create_object(zend_class_entry *ce)
+{
+    h3_lat_lng_object *intern = h3_geometry_object_alloc(sizeof(h3_lat_lng_object), ce);
+
+    zend_object_std_init(&intern->std, ce);
+    object_properties_init(&intern->std, ce);
+    intern->std.handlers = &h3_lat_lng_handlers;
+
+    return &intern->std;
+}
+
+zend_object *h3_lat_lng_clone_obj(zend_object *old_obj)
+{
+    zend_object *new_obj = h3_lat_lng_create_object(old_obj->ce);
+    zend_objects_clone_members(new_obj, old_obj);
+
+    return new_obj;
+}
+
+zend_object *h3_cell_boundary_create_object(zend_class_entry *ce)
+{
+    h3_cell_boundary_object *intern = h3_geometry_object_alloc(sizeof(h3_cell_boundary_object), ce);
+
+    zend_object_std_init(&intern->std, ce);
+    object_properties_init(&intern->std, ce);
+    intern->std.handlers = &h3_cell_boundary_handlers;
+
+    return &intern->std;
+}
+
+zend_object *h3_cell_boundary_clone_obj(zend_object *old_obj)
+{
+    zend_object *new_obj = h3_cell_boundary_create_object(old_obj->ce);
+    zend_objects_clone_members(new_obj, old_obj);
+
+    return new_obj;
+}
+
+void h3_cell_boundary_free_obj(zend_object *obj)
+{
+    h3_cell_boundary_object *intern = H3_OBJ(h3_cell_boundary_object, obj);
+
+    if (intern->loop.verts) {
+        efree(intern->loop.verts);
+    }
+
+    zend_object_std_dtor(obj);
+}
+
+zend_object *h3_geo_polygon_create_object(zend_class_entry *ce)
+{
+    h3_geo_polygon_object *intern = h3_geometry_object_alloc(sizeof(h3_geo_polygon_object), ce);
+
+    zend_object_std_init(&intern->std, ce);
+    object_properties_init(&intern->std, ce);
+    intern->std.handlers = &h3_geo_polygon_handlers;
+
+    return &intern->std;
+}
+
+zend_object *h3_geo_polygon_clone_obj(zend_object *old_obj)
+{
+    zend_object *new_obj = h3_geo_polygon_create_object(old_obj->ce);
+    zend_objects_clone_members(new_obj, old_obj);
+
+    return new_obj;
+}
+
+void h3_geo_polygon_free_obj(zend_object *obj)
+{
+    h3_geo_polygon_object *intern = H3_OBJ(h3_geo_polygon_object, obj);
+
+    if (intern->polygon.holes) {
+        efree(intern->polygon.holes);
+    }
+
+    zend_object_std_dtor(obj);
+}
+
+// Cached geometries stay valid until a geometry object that already holds
+// data is constructed again, which bumps the epoch and drops every cache.
+void h3_geometry_construct(zend_object *obj)
+{
+    if (Z_TYPE_P(OBJ_PROP_NUM(obj, 0)) != IS_UNDEF) {
+        H3_G(geometry_epoch)++;
+    }
+}
+
+const LatLng *obj_to_cached_geo(zend_object *obj)
+{
+    h3_lat_lng_object *intern = H3_OBJ(h3_lat_lng_object, obj);
+    zval *prop;
+    zval rv;
+
+    if (!H3_GEOMETRY_CACHE_VALID(intern)) {
+        prop = zend_read_property(H3_LatLng_ce, obj, "lat", sizeof("lat") - 1, 1, &rv);
+        intern->coord.lat = degsToRads(zval_get_double(prop));
+        prop = zend_read_property(H3_LatLng_ce, obj, "lon", sizeof("lon") - 1, 1, &rv);
+        intern->coord.lng = degsToRads(zval_get_double(prop));
+
+        intern->cached = true;
+        intern->epoch = H3_G(geometry_epoch);
+    }
+
+    return &intern->coord;
+}
+
+void obj_to_geo(zend_object *obj, LatLng *geo)
+{
+    *geo = *obj_to_cached_geo(obj);
+}
+
+zend_object *geo_to_obj(LatLng *geo)
+{
+    zend_object *obj = H3_LatLng_ce->create_object(H3_LatLng_ce);
+
+    zend_update_property_double(H3_LatLng_ce, obj, "lat", sizeof("lat") - 1, radsToDegs(geo->lat));
+    zend_update_property_double(H3_LatLng_ce, obj, "lon", sizeof("lon") - 1, radsToDegs(geo->lng));
+
+    return obj;
+}
+
+zend_object *geo_boundary_to_obj(CellBoundary *boundary)
+{
+    zval val;
+    array_init_size(&val, boundary->numVerts);
+
+    for (int i = 0; i < boundary->numVerts; i++) {
+        add_next_index_object(&val, geo_to_obj(&boundary->verts[i]));
+    }
+
+    zend_object *obj = H3_CellBoundary_ce->create_object(H3_CellBoundary_ce);
+
+    zend_update_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, &val);
+
+    zval_ptr_dtor(&val);
+
+    return obj;
+}
+
+const GeoLoop *obj_to_geoloop(zend_object *obj)
+{
+    h3_cell_boundary_object *intern = H3_OBJ(h3_cell_boundary_object, obj);
+    zval *prop;
+    zval rv;
+    zend_array *arr;
+    int idx = 0;
+    zval *val;
+
+    if (H3_GEOMETRY_CACHE_VALID(intern)) {
+        return &intern->loop;
+    }
+
+    prop = zend_read_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, 1, &rv);
+    if (Z_TYPE_P(prop) != IS_ARRAY) {
+        return NULL;
+    }
+    arr = Z_ARR_P(prop);
+
+    uint32_t num_verts = zend_array_count(arr);
+    LatLng *verts = safe_emalloc(num_verts, sizeof(LatLng), 0);
+
+    ZEND_HASH_FOREACH_VAL(arr, val)
+    {
+        if (OBJ_IS_A(val, H3_LatLng_ce)) {
+            verts[idx++] = *obj_to_cached_geo(Z_OBJ_P(val));
+        } else {
+            efree(verts);
+            return NULL;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (intern->loop.verts) {
+        efree(intern->loop.verts);
+    }
+
+    intern->loop.numVerts = num_verts;
+    intern->loop.verts = verts;
+    intern->cached = true;
+    intern->epoch = H3_G(geometry_epoch);
+
+    return &intern->loop;
+}
+
+void geoloop_to_bbox(const GeoLoop *loop, h3_bbox *bbox)
+{
+    double min_pos_lng = M_PI;
+    double max_neg_lng = -M_PI;
+    bool transmeridian = false;
+
+    if (loop->numVerts == 0) {
+        memset(bbox, 0, sizeof(h3_bbox));
+        return;
+    }
+
+    bbox->north = -M_PI_2;
+    bbox->south = M_PI_2;
+    bbox->east = -M_PI;
+    bbox->west = M_PI;
+
+    for (int i = 0; i < loop->numVerts; i++) {
+        const LatLng *coord = &loop->verts[i];
+        const LatLng *next = &loop->verts[(i + 1) % loop->numVerts];
+
+        bbox->north = MAX(bbox->north, coord->lat);
+        bbox->south = MIN(bbox->south, coord->lat);
+        bbox->east = MAX(bbox->east, coord->lng);
+        bbox->west = MIN(bbox->west, coord->lng);
+
+        if (coord->lng > 0 && coord->lng < min_pos_lng) {
+            min_pos_lng = coord->lng;
+        }
+        if (coord->lng < 0 && coord->lng > max_neg_lng) {
+            max_neg_lng = coord->lng;
+        }
+        if (fabs(coord->lng - next->lng) > M_PI) {
+            transmeridian = true;
+        }
+    }
+
+    if (transmeridian) {
+        bbox->east = max_neg_lng;
+        bbox->west = min_pos_lng;
+    }
+}
+
+const GeoPolygon *obj_to_geopolygon(zend_object *obj, const h3_bbox **bbox)
+{
+    h3_geo_polygon_object *intern = H3_OBJ(h3_geo_polygon_object, obj);
+    zval *prop;
+    zval rv;
+    zend_array *holes_arr;
+    zval *val;
+    const GeoLoop *geofence;
+    const GeoLoop *hole;
+    GeoLoop *holes = NULL;
+    int idx = 0;
+
+    if (H3_GEOMETRY_CACHE_VALID(intern)) {
+        if (bbox) {
+            *bbox = &intern->bbox;
+        }
+        return &intern->polygon;
+    }
+
+    prop = zend_read_property(H3_GeoPolygon_ce, obj, "geofence", sizeof("geofence") - 1, 1, &rv);
+    if (!OBJ_IS_A(prop, H3_CellBoundary_ce) || !(geofence = obj_to_geoloop(Z_OBJ_P(prop)))) {
+        return NULL;
+    }
+
+    prop = zend_read_property(H3_GeoPolygon_ce, obj, "holes", sizeof("holes") - 1, 1, &rv);
+    if (Z_TYPE_P(prop) != IS_ARRAY) {
+        return NULL;
+    }
+    holes_arr = Z_ARR_P(prop);
+
+    uint32_t num_holes = zend_array_count(holes_arr);
+    if (num_holes > 0) {
+        holes = safe_emalloc(num_holes, sizeof(GeoLoop), 0);
+    }
+
+    // the loops point into the CellBoundary caches, which are only rebuilt
+    // after an epoch bump that also invalidates this polygon
+    ZEND_HASH_FOREACH_VAL(holes_arr, val)
+    {
+        if (OBJ_IS_A(val, H3_CellBoundary_ce) && (hole = obj_to_geoloop(Z_OBJ_P(val)))) {
+            holes[idx++] = *hole;
+        } else {
+            efree(holes);
+            return NULL;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (intern->polygon.holes) {
+        efree(intern->polygon.holes);
+    }
+
+    intern->polygon.geoloop = *geofence;
+    intern->polygon.numHoles = num_holes;
+    intern->polygon.holes = holes;
+    geoloop_to_bbox(geofence, &intern->bbox);
+    intern->cached = true;
+    intern->epoch = H3_G(geometry_epoch);
+
+    if (bbox) {
+        *bbox = &intern->bbox;
+    }
+
+    return &intern->polygon;
+}
+
+zend_object *geo_degs_to_obj(double lat, double lon)
+{
+    zend_object *obj = H3_LatLng_ce->create_object(H3_LatLng_ce);
+    h3_lat_lng_object *intern = H3_OBJ(h3_lat_lng_object, obj);
+
+    zend_update_property_double(H3_LatLng_ce, obj, "lat", sizeof("lat") - 1, lat);
+    zend_update_property_double(H3_LatLng_ce, obj, "lon", sizeof("lon") - 1, lon);
+
+    intern->coord.lat = degsToRads(lat);
+    intern->coord.lng = degsToRads(lon);
+    intern->cached = true;
+    intern->epoch = H3_G(geometry_epoch);
+
+    return obj;
+}
+
+zend_object *geoloop_to_boundary_obj(const GeoLoop *loop, zval *vertices)
+{
+    zend_object *obj = H3_CellBoundary_ce->create_object(H3_CellBoundary_ce);
+    h3_cell_boundary_object *intern = H3_OBJ(h3_cell_boundary_object, obj);
+
+    zend_update_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, vertices);
+
+    intern->loop = *loop;
+    intern->cached = true;
+    intern->epoch = H3_G(geometry_epoch);
+
+    return obj;
+}
+
+int zval_to_double(zval *val, double *out)
+{
+    ZVAL_DEREF(val);
+
+    if (Z_TYPE_P(val) == IS_DOUBLE) {
+        *out = Z_DVAL_P(val);
+        return 0;
+    }
+
+    if (Z_TYPE_P(val) == IS_LONG) {
+        *out = (double) Z_LVAL_P(val);
+        return 0;
+    }
+
+    return -1;
+}
+
+int geo_json_position_to_degrees(zval *val, double *lon, double *lat)
+{
+    zval *coord;
+
+    ZVAL_DEREF(val);
+
+    if (Z_TYPE_P(val) != IS_ARRAY) {
+        return -1;
+    }
+
+    coord = zend_hash_index_find(Z_ARR_P(val), 0);
+    if (!coord || zval_to_double(coord, lon) != 0) {
+        return -1;
+    }
+
+    coord = zend_hash_index_find(Z_ARR_P(val), 1);
+    if (!coord || zval_to_double(coord, lat) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Reads a GeoJSON ring of [lon, lat] positions, or with flat set a
+// [lon, lat, lon, lat, ...] list, dropping the closing vertex. When vertices
+// is given it is filled with the matching LatLng objects.
+int geo_json_ring_to_geoloop(zend_array *ring, bool flat, GeoLoop *out, zval *vertices)
+{
+    uint32_t count = zend_array_count(ring);
+    uint32_t num_verts = flat ? count / 2 : count;
+    LatLng *verts;
+    double *degs;
+    zval *val;
+    uint32_t idx = 0;
+
+    if (flat && count % 2 != 0) {
+        return -1;
+    }
+
+    verts = safe_emalloc(num_verts, sizeof(LatLng), 0);
+    degs = safe_emalloc(num_verts, 2 * sizeof(double), 0);
+
+    ZEND_HASH_FOREACH_VAL(ring, val)
+    {
+        if (flat ? zval_to_double(val, &degs[idx]) != 0
+                 : geo_json_position_to_degrees(val, &degs[idx * 2], &degs[idx * 2 + 1]) != 0) {
+            efree(verts);
+            efree(degs);
+            return -1;
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (num_verts > 1 && degs[0] == degs[num_verts * 2 - 2] && degs[1] == degs[num_verts * 2 - 1]) {
+        num_verts--;
+    }
+
+    if (vertices) {
+        array_init_size(vertices, num_verts);
+    }
+
+    for (idx = 0; idx < num_verts; idx++) {
+        verts[idx].lng = degsToRads(degs[idx * 2]);
+        verts[idx].lat = degsToRads(degs[idx * 2 + 1]);
+
+        if (vertices) {
+            add_next_index_object(vertices, geo_degs_to_obj(degs[idx * 2 + 1], degs[idx * 2]));
+        }
+    }
+
+    efree(degs);
+
+    out->numVerts = num_verts;
+    out->verts = verts;
+
+    return 0;
+}
+
+void geopolygon_free(GeoPolygon *polygon)
+{
+    efree(polygon->geoloop.verts);
+
+    for (int i = 0; i < polygon->numHoles; i++) {
+        efree(polygon->holes[i].verts);
+    }
+
+    if (polygon->holes) {
+        efree(polygon->holes);
+    }
+}
+
+int geo_json_polygon_to_geopolygon(zend_array *rings, GeoPolygon *out)
+{
+    zval *ring;
+    int idx = 0;
+    uint32_t num_rings = zend_array_count(rings);
+
+    if (num_rings == 0) {
+        return -1;
+    }
+
+    out->numHoles = num_rings - 1;
+    out->holes = out->numHoles > 0 ? safe_emalloc(out->numHoles, sizeof(GeoLoop), 0) : NULL;
+
+    ZEND_HASH_FOREACH_VAL(rings, ring)
+    {
+        ZVAL_DEREF(ring);
+        if (Z_TYPE_P(ring) != IS_ARRAY
+            || geo_json_ring_to_geoloop(Z_ARR_P(ring), false, idx == 0 ? &out->geoloop : &out->holes[idx - 1], NULL) != 0) {
+            out->numHoles = idx > 0 ? idx - 1 : 0;
+            if (idx > 0) {
+                geopolygon_free(out);
+            } else if (out->holes) {
+                efree(out->holes);
+            }
+            return -1;
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return 0;
+}
+
+int geo_json_depth(zval *val)
+{
+    int depth = 0;
+
+    ZVAL_DEREF(val);
+    while (val && Z_TYPE_P(val) == IS_ARRAY) {
+        depth++;
+        val = zend_hash_index_find(Z_ARR_P(val), 0);
+        if (val) {
+            ZVAL_DEREF(val);
+        }
+    }
+
+    return val && (Z_TYPE_P(val) == IS_DOUBLE || Z_TYPE_P(val) == IS_LONG) ? depth : -1;
+}
+
+// Accepts a GeoJSON Polygon or MultiPolygon geometry, the coordinates of one,
+// or a flat [lon, lat, ...] ring. Returns the number of polygons written to
+// out, or -1 if the array is not in one of those forms.
+int geo_json_to_geopolygons(zend_array *arr, GeoPolygon **out)
+{
+    zval *type;
+    zval *coordinates;
+    zval arr_val;
+    zval *polygon;
+    int depth;
+    int num_polygons;
+    int idx = 0;
+
+    type = zend_hash_str_find(arr, "type", sizeof("type") - 1);
+    if (type) {
+        coordinates = zend_hash_str_find(arr, "coordinates", sizeof("coordinates") - 1);
+        if (Z_TYPE_P(type) != IS_STRING || !coordinates) {
+            return -1;
+        }
+        ZVAL_DEREF(coordinates);
+        if (Z_TYPE_P(coordinates) != IS_ARRAY) {
+            return -1;
+        }
+        depth = geo_json_depth(coordinates);
+        if ((zend_string_equals_literal(Z_STR_P(type), "Polygon") && depth != 3)
+            || (zend_string_equals_literal(Z_STR_P(type), "MultiPolygon") && depth != 4)
+            || (!zend_string_equals_literal(Z_STR_P(type), "Polygon")
+                && !zend_string_equals_literal(Z_STR_P(type), "MultiPolygon"))) {
+            return -1;
+        }
+        arr = Z_ARR_P(coordinates);
+    } else {
+        ZVAL_ARR(&arr_val, arr);
+        depth = geo_json_depth(&arr_val);
+    }
+
+    if (depth == 1 || depth == 3) {
+        *out = emalloc(sizeof(GeoPolygon));
+
+        if (depth == 1) {
+            (*out)->numHoles = 0;
+            (*out)->holes = NULL;
+            if (geo_json_ring_to_geoloop(arr, true, &(*out)->geoloop, NULL) != 0) {
+                efree(*out);
+                return -1;
+            }
+        } else if (geo_json_polygon_to_geopolygon(arr, *out) != 0) {
+            efree(*out);
+            return -1;
+        }
+
+        return 1;
+    }
+
+    if (depth != 4) {
+        return -1;
+    }
+
+    num_polygons = zend_array_count(arr);
+    *out = safe_emalloc(num_polygons, sizeof(GeoPolygon), 0);
+
+    ZEND_HASH_FOREACH_VAL(arr, polygon)
+    {
+        ZVAL_DEREF(polygon);
+        if (Z_TYPE_P(polygon) != IS_ARRAY || geo_json_polygon_to_geopolygon(Z_ARR_P(polygon), &(*out)[idx]) != 0) {
+            while (idx-- > 0) {
+                geopolygon_free(&(*out)[idx]);
+            }
+            efree(*out);
+            return -1;
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return num_polygons;
+}
+
+void h3_line(zend_object *start, zend_object *end, INTERNAL_FUNCTION_PARAMETERS)
+{
+    H3Index startIndex = obj_to_h3(start);
+    H3Index endIndex = obj_to_h3(end);
+
+    int64_t size;
+    H3Error err = gridPathCellsSize(startIndex, endIndex, &size);
+
+    if (err) {
+        H3_THROW("Failed to calculate line size", H3_ERR_CODE_LINE_SIZE_ERROR);
+        RETURN_THROWS();
+    }
+
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *out = h3_scratch_calloc(size, sizeof(H3Index));
+    err = gridPathCells(startIndex, endIndex, out);
+
+    if (err) {
+        H3_THROW("Failed to calculate line", H3_ERR_CODE_LINE_SIZE_ERROR);
+        h3_scratch_restore(mark);
+        RETURN_THROWS();
+    }
+
+    array_init(return_value);
+    h3_array_to_zend_array(out, size, return_value);
+
+    h3_scratch_restore(mark);
+}
+
+int geofence_obj_to_geojson_arr(zend_object *geofence_obj, zval *geojson_geofence_val)
+{
+    zval *prop;
+    zval rv;
+    zend_array *geofence_verts_arr;
+    zval *geofence_vert_val;
+    zend_object *coord_obj;
+    zval coords_val;
+    zval first_coords_val;
+    int idx = 0;
+    uint32_t verts_count;
+
+    prop = zend_read_property(H3_CellBoundary_ce, geofence_obj, "vertices", sizeof("vertices") - 1, 1, &rv);
+    geofence_verts_arr = Z_ARRVAL_P(prop);
+    verts_count = zend_array_count(geofence_verts_arr);
+
+    if (verts_count == 0) {
+        return -1;
+    }
+
+    array_init_size(geojson_geofence_val, 1 + verts_count);
+
+    ZEND_HASH_FOREACH_VAL(geofence_verts_arr, geofence_vert_val)
+    {
+        if (Z_TYPE_P(geofence_vert_val) == IS_OBJECT && OBJ_IS_A(geofence_vert_val, H3_LatLng_ce)) {
+            coord_obj = Z_OBJ_P(geofence_vert_val);
+            array_init_size(&coords_val, 2);
+            prop = zend_read_property(H3_LatLng_ce, coord_obj, "lon", sizeof("lon") - 1, 1, &rv);
+            add_next_index_double(&coords_val, Z_DVAL_P(prop));
+            prop = zend_read_property(H3_LatLng_ce, coord_obj, "lat", sizeof("lat") - 1, 1, &rv);
+            add_next_index_double(&coords_val, Z_DVAL_P(prop));
+            add_next_index_zval(geojson_geofence_val, &coords_val);
+            if (idx++ == 0) {
+                ZVAL_COPY(&first_coords_val, &coords_val);
+            }
+        } else {
+            zval_ptr_dtor(geojson_geofence_val);
+            return -1;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    add_next_index_zval(geojson_geofence_val, &first_coords_val);
+
+    return 0;
+}
+
+int multi_polygon_obj_to_geo_json(zend_object *obj, zval *return_value)
+{
+    zval *prop;
+    zval rv;
+    zend_array *polygons_arr;
+    zval *val;
+    zend_object *polygon_obj;
+    zend_object *geofence_obj;
+    zend_array *holes_arr;
+    zval geojson_polygon_val;
+    zval coords_val;
+    zval *hole_val;
+
+    prop = zend_read_property(H3_GeoMultiPolygon_ce, obj, "polygons", sizeof("polygons") - 1, 1, &rv);
+    polygons_arr = Z_ARRVAL_P(prop);
+
+    array_init_size(return_value, zend_array_count(polygons_arr));
+
+    ZEND_HASH_FOREACH_VAL(polygons_arr, val)
+    {
+        if (Z_TYPE_P(val) == IS_OBJECT && OBJ_IS_A(val, H3_GeoPolygon_ce)) {
+            polygon_obj = Z_OBJ_P(val);
+
+            prop = zend_read_property(H3_GeoPolygon_ce, polygon_obj, "geofence", sizeof("geofence") - 1, 1, &rv);
+            geofence_obj = Z_OBJ_P(prop);
+
+            prop = zend_read_property(H3_GeoPolygon_ce, polygon_obj, "holes", sizeof("holes") - 1, 1, &rv);
+            holes_arr = Z_ARRVAL_P(prop);
+
+            array_init_size(&geojson_polygon_val, 1 + zend_array_count(holes_arr));
+
+            if (geofence_obj_to_geojson_arr(geofence_obj, &coords_val) == 0) {
+                add_next_index_zval(&geojson_polygon_val, &coords_val);
+            } else {
+                zval_ptr_dtor(&geojson_polygon_val);
+                return -1;
+            }
+
+            ZEND_HASH_FOREACH_VAL(holes_arr, hole_val)
+            {
+                if (Z_TYPE_P(hole_val) == IS_OBJECT && OBJ_IS_A(hole_val, H3_CellBoundary_ce)) {
+                    if (geofence_obj_to_geojson_arr(Z_OBJ_P(hole_val), &coords_val) == 0) {
+                        add_next_index_zval(&geojson_polygon_val, &coords_val);
+                    } else {
+                        zval_ptr_dtor(&geojson_polygon_val);
+                        return -1;
+                    }
+                } else {
+                    zval_ptr_dtor(&geojson_polygon_val);
+                    return -1;
+                }
+            }
+            ZEND_HASH_FOREACH_END();
+
+            add_next_index_zval(return_value, &geojson_polygon_val);
+        } else {
+            return -1;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return 0;
+}
+
+zend_object *geo_loop_to_geo_boundary_obj(LinkedGeoLoop *geo_loop)
+{
+    LinkedLatLng *geo_coord;
+    zval coords_val;
+    zend_object *obj;
+
+    array_init(&coords_val);
+
+    geo_coord = geo_loop->first;
+    while (geo_coord) {
+        add_next_index_object(&coords_val, geo_to_obj(&geo_coord->vertex));
+        geo_coord = geo_coord->next;
+    }
+
+    obj = H3_CellBoundary_ce->create_object(H3_CellBoundary_ce);
+    zend_update_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, &coords_val);
+
+    Z_TRY_DELREF(coords_val);
+
+    return obj;
+}
+
+void h3_writer_init(h3_writer *writer, php_stream *stream)
+{
+    memset(&writer->buf, 0, sizeof(smart_str));
+    writer->stream = stream;
+    writer->written = 0;
+}
+
+int h3_writer_flush(h3_writer *writer, size_t threshold)
+{
+    if (!writer->stream || !writer->buf.s || ZSTR_LEN(writer->buf.s) == 0 || ZSTR_LEN(writer->buf.s) < threshold) {
+        return 0;
+    }
+
+    size_t len = ZSTR_LEN(writer->buf.s);
+    ssize_t written = php_stream_write(writer->stream, ZSTR_VAL(writer->buf.s), len);
+    if (written < 0 || (size_t) written != len) {
+        return -1;
+    }
+
+    writer->written += len;
+    ZSTR_LEN(writer->buf.s) = 0;
+
+    return 0;
+}
+
+void h3_writer_finish(h3_writer *writer, zval *return_value)
+{
+    if (writer->stream) {
+        if (h3_writer_flush(writer, 0) != 0) {
+            smart_str_free(&writer->buf);
+            H3_THROW("Failed to write to stream", 0);
+            RETURN_THROWS();
+        }
+        smart_str_free(&writer->buf);
+        RETURN_LONG(writer->written);
+    }
+
+    if (!writer->buf.s) {
+        RETURN_EMPTY_STRING();
+    }
+
+    RETURN_STR(smart_str_extract(&writer->buf));
+}
+
+void geo_json_append_double(smart_str *buf, double value)
+{
+    char num[64];
+
+    php_gcvt(value, (int) PG(serialize_precision), '.', 'e', num);
+    smart_str_appends(buf, num);
+}
+
+void geo_json_append_coord(smart_str *buf, const LatLng *coord)
+{
+    smart_str_appendc(buf, '[');
+    geo_json_append_double(buf, radsToDegs(coord->lng));
+    smart_str_appendc(buf, ',');
+    geo_json_append_double(buf, radsToDegs(coord->lat));
+    smart_str_appendc(buf, ']');
+}
+
+void linked_geo_loop_to_geo_json(smart_str *buf, const LinkedGeoLoop *geo_loop)
+{
+    const LinkedLatLng *geo_coord = geo_loop->first;
+
+    smart_str_appendc(buf, '[');
+    while (geo_coord) {
+        geo_json_append_coord(buf, &geo_coord->vertex);
+        smart_str_appendc(buf, ',');
+        geo_coord = geo_coord->next;
+    }
+
+    if (geo_loop->first) {
+        geo_json_append_coord(buf, &geo_loop->first->vertex);
+    }
+    smart_str_appendc(buf, ']');
+}
+
+int linked_multi_polygon_to_geo_json(h3_writer *writer, const LinkedGeoPolygon *polygon)
+{
+    const LinkedGeoLoop *geo_loop;
+    bool first_polygon = true;
+
+    smart_str_appends(&writer->buf, "{\"type\":\"MultiPolygon\",\"coordinates\":[");
+
+    while (polygon) {
+        if (polygon->first) {
+            if (!first_polygon) {
+                smart_str_appendc(&writer->buf, ',');
+            }
+            first_polygon = false;
+
+            smart_str_appendc(&writer->buf, '[');
+            geo_loop = polygon->first;
+            while (geo_loop) {
+                linked_geo_loop_to_geo_json(&writer->buf, geo_loop);
+                geo_loop = geo_loop->next;
+                if (geo_loop) {
+                    smart_str_appendc(&writer->buf, ',');
+                }
+            }
+            smart_str_appendc(&writer->buf, ']');
+
+            if (h3_writer_flush(writer, H3_STREAM_CHUNK_SIZE) != 0) {
+                return -1;
+            }
+        }
+        polygon = polygon->next;
+    }
+
+    smart_str_appends(&writer->buf, "]}");
+
+    return 0;
+}
+
+int geo_json_append_properties(smart_str *buf, zval *properties)
+{
+    zend_ulong num_key;
+    zend_string *str_key;
+    zval *val;
+    zval key_val;
+    bool first = true;
+
+    if (!properties || Z_TYPE_P(properties) == IS_NULL) {
+        smart_str_appends(buf, "null");
+        return 0;
+    }
+
+    if (Z_TYPE_P(properties) != IS_ARRAY) {
+        return -1;
+    }
+
+    smart_str_appendc(buf, '{');
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(properties), num_key, str_key, val)
+    {
+        if (!first) {
+            smart_str_appendc(buf, ',');
+        }
+        first = false;
+
+        if (str_key) {
+            ZVAL_STR(&key_val, str_key);
+            if (php_json_encode(buf, &key_val, 0) != SUCCESS) {
+                return -1;
+            }
+        } else {
+            smart_str_appendc(buf, '"');
+            smart_str_append_long(buf, (zend_long) num_key);
+            smart_str_appendc(buf, '"');
+        }
+        smart_str_appendc(buf, ':');
+        if (php_json_encode(buf, val, 0) != SUCCESS) {
+            return -1;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    smart_str_appendc(buf, '}');
+
+    return 0;
+}
+
+int cell_to_geo_json_feature(smart_str *buf, H3Index index, zval *properties)
+{
+    CellBoundary boundary;
+    char id[H3_STRVAL_LEN];
+    int id_len = h3_hex_len(index);
+
+    if (cellToBoundary(index, &boundary)) {
+        return -1;
+    }
+    h3_to_hex(index, id, id_len);
+
+    smart_str_appends(buf, "{\"type\":\"Feature\",\"id\":\"");
+    smart_str_appendl(buf, id, id_len);
+    smart_str_appends(buf, "\",\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[");
+    for (int i = 0; i < boundary.numVerts; i++) {
+        geo_json_append_coord(buf, &boundary.verts[i]);
+        smart_str_appendc(buf, ',');
+    }
+    geo_json_append_coord(buf, &boundary.verts[0]);
+    smart_str_appends(buf, "]]},\"properties\":");
+
+    if (geo_json_append_properties(buf, properties) != 0) {
+        return -1;
+    }
+    smart_str_appendc(buf, '}');
+
+    return 0;
+}
+
+void wkb_append_uint32(smart_str *buf, uint32_t value)
+{
+    smart_str_appendl(buf, (const char *) &value, sizeof(uint32_t));
+}
+
+void wkb_append_point(smart_str *buf, double lon, double lat)
+{
+    smart_str_appendl(buf, (const char *) &lon, sizeof(double));
+    smart_str_appendl(buf, (const char *) &lat, sizeof(double));
+}
+
+void wkb_append_header(smart_str *buf, uint32_t type, bool extended)
+{
+    smart_str_appendc(buf, H3_WKB_BYTE_ORDER);
+
+    if (extended) {
+        wkb_append_uint32(buf, type | H3_EWKB_SRID_FLAG);
+        wkb_append_uint32(buf, H3_EWKB_SRID);
+    } else {
+        wkb_append_uint32(buf, type);
+    }
+}
+
+void cell_boundary_to_wkb(smart_str *buf, const CellBoundary *boundary, bool extended)
+{
+    wkb_append_header(buf, H3_WKB_POLYGON, extended);
+    wkb_append_uint32(buf, 1);
+    wkb_append_uint32(buf, boundary->numVerts + 1);
+
+    for (int i = 0; i < boundary->numVerts; i++) {
+        wkb_append_point(buf, radsToDegs(boundary->verts[i].lng), radsToDegs(boundary->verts[i].lat));
+    }
+    wkb_append_point(buf, radsToDegs(boundary->verts[0].lng), radsToDegs(boundary->verts[0].lat));
+}
+
+void linked_geo_polygon_to_wkb(smart_str *buf, const LinkedGeoPolygon *polygon)
+{
+    const LinkedGeoLoop *geo_loop;
+    const LinkedLatLng *geo_coord;
+    uint32_t num_loops = 0;
+    uint32_t num_verts;
+
+    for (geo_loop = polygon->first; geo_loop; geo_loop = geo_loop->next) {
+        num_loops++;
+    }
+
+    wkb_append_header(buf, H3_WKB_POLYGON, false);
+    wkb_append_uint32(buf, num_loops);
+
+    for (geo_loop = polygon->first; geo_loop; geo_loop = geo_loop->next) {
+        num_verts = 0;
+        for (geo_coord = geo_loop->first; geo_coord; geo_coord = geo_coord->next) {
+            num_verts++;
+        }
+
+        wkb_append_uint32(buf, num_verts ? num_verts + 1 : 0);
+
+        for (geo_coord = geo_loop->first; geo_coord; geo_coord = geo_coord->next) {
+            wkb_append_point(buf, radsToDegs(geo_coord->vertex.lng), radsToDegs(geo_coord->vertex.lat));
+        }
+        if (geo_loop->first) {
+            wkb_append_point(buf, radsToDegs(geo_loop->first->vertex.lng), radsToDegs(geo_loop->first->vertex.lat));
+        }
+    }
+}
+
+void linked_multi_polygon_to_wkb(smart_str *buf, const LinkedGeoPolygon *polygon, bool extended)
+{
+    const LinkedGeoPolygon *cur;
+    uint32_t num_polygons = 0;
+
+    for (cur = polygon; cur; cur = cur->next) {
+        if (cur->first) {
+            num_polygons++;
+        }
+    }
+
+    wkb_append_header(buf, H3_WKB_MULTI_POLYGON, extended);
+    wkb_append_uint32(buf, num_polygons);
+
+    for (cur = polygon; cur; cur = cur->next) {
+        if (cur->first) {
+            linked_geo_polygon_to_wkb(buf, cur);
+        }
+    }
+}
+
+int geofence_obj_to_wkb(zend_object *geofence_obj, smart_str *buf)
+{
+    zval *prop;
+    zval rv;
+    zend_array *verts_arr;
+    zval *vert_val;
+    double first_lon = 0;
+    double first_lat = 0;
+    double lon;
+    double lat;
+    int idx = 0;
+
+    prop = zend_read_property(H3_CellBoundary_ce, geofence_obj, "vertices", sizeof("vertices") - 1, 1, &rv);
+    verts_arr = Z_ARRVAL_P(prop);
+
+    if (zend_array_count(verts_arr) == 0) {
+        return -1;
+    }
+
+    wkb_append_uint32(buf, zend_array_count(verts_arr) + 1);
+
+    ZEND_HASH_FOREACH_VAL(verts_arr, vert_val)
+    {
+        if (!OBJ_IS_A(vert_val, H3_LatLng_ce)) {
+            return -1;
+        }
+
+        prop = zend_read_property(H3_LatLng_ce, Z_OBJ_P(vert_val), "lon", sizeof("lon") - 1, 1, &rv);
+        lon = zval_get_double(prop);
+        prop = zend_read_property(H3_LatLng_ce, Z_OBJ_P(vert_val), "lat", sizeof("lat") - 1, 1, &rv);
+        lat = zval_get_double(prop);
+
+        wkb_append_point(buf, lon, lat);
+
+        if (idx++ == 0) {
+            first_lon = lon;
+            first_lat = lat;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    wkb_append_point(buf, first_lon, first_lat);
+
+    return 0;
+}
+
+int multi_polygon_obj_to_wkb(zend_object *obj, smart_str *buf, bool extended)
+{
+    zval *prop;
+    zval rv;
+    zend_array *polygons_arr;
+    zend_array *holes_arr;
+    zend_object *geofence_obj;
+    zval *val;
+    zval *hole_val;
+
+    prop = zend_read_property(H3_GeoMultiPolygon_ce, obj, "polygons", sizeof("polygons") - 1, 1, &rv);
+    polygons_arr = Z_ARRVAL_P(prop);
+
+    wkb_append_header(buf, H3_WKB_MULTI_POLYGON, extended);
+    wkb_append_uint32(buf, zend_array_count(polygons_arr));
+
+    ZEND_HASH_FOREACH_VAL(polygons_arr, val)
+    {
+        if (!OBJ_IS_A(val, H3_GeoPolygon_ce)) {
+            return -1;
+        }
+
+        prop = zend_read_property(H3_GeoPolygon_ce, Z_OBJ_P(val), "geofence", sizeof("geofence") - 1, 1, &rv);
+        geofence_obj = Z_OBJ_P(prop);
+
+        prop = zend_read_property(H3_GeoPolygon_ce, Z_OBJ_P(val), "holes", sizeof("holes") - 1, 1, &rv);
+        holes_arr = Z_ARRVAL_P(prop);
+
+        wkb_append_header(buf, H3_WKB_POLYGON, false);
+        wkb_append_uint32(buf, 1 + zend_array_count(holes_arr));
+
+        if (geofence_obj_to_wkb(geofence_obj, buf) != 0) {
+            return -1;
+        }
+
+        ZEND_HASH_FOREACH_VAL(holes_arr, hole_val)
+        {
+            if (!OBJ_IS_A(hole_val, H3_CellBoundary_ce) || geofence_obj_to_wkb(Z_OBJ_P(hole_val), buf) != 0) {
+                return -1;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return 0;
+}
+
+// Set once in MINIT, read only afterwards
+int h3_online_cpus = 1;
+
+// h3.threads, capped at the CPUs online when the module was started
+int h3_threads(void)
+{
+    zend_long threads = MIN(H3_G(threads), h3_online_cpus);
+
+    return threads < 1 ? 1 : (int) threads;
+}
+
+void *h3_pool_worker(void *arg)
+{
+    h3_pool *pool = arg;
+    size_t idx;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        idx = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (idx >= pool->num_tasks) {
+            return NULL;
+        }
+
+        pool->fn(pool->tasks + idx * pool->task_size);
+    }
+}
+
+// Runs fn over every task on up to num_threads threads, the calling thread
+// included. Tasks run off the request thread, so they must not touch the Zend
+// engine or its allocator.
+void h3_pool_run(h3_task_fn fn, void *tasks, size_t task_size, size_t num_tasks, int num_threads)
+{
+    h3_pool pool = {
+        .fn = fn,
+        .tasks = tasks,
+        .task_size = task_size,
+        .num_tasks = num_tasks,
+        .next = 0,
+    };
+    pthread_t threads[H3_MAX_THREADS];
+    int started = 0;
+
+    if ((size_t) num_threads > num_tasks) {
+        num_threads = (int) num_tasks;
+    }
+
+    pthread_mutex_init(&pool.lock, NULL);
+
+    for (int i = 1; i < num_threads; i++) {
+        if (pthread_create(&threads[started], NULL, h3_pool_worker, &pool) == 0) {
+            started++;
+        }
+    }
+
+    h3_pool_worker(&pool);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool.lock);
+}
+
+LatLng lat_intersection(const LatLng *a, const LatLng *b, double lat)
+{
+    double t = (lat - a->lat) / (b->lat - a->lat);
+    LatLng out = {
+        .lat = lat,
+        .lng = a->lng + t * (b->lng - a->lng),
+    };
+
+    return out;
+}
+
+int clip_verts_lat(const LatLng *in, int num_verts, double bound, bool keep_above, LatLng *out)
+{
+    int count = 0;
+
+    for (int i = 0; i < num_verts; i++) {
+        const LatLng *prev = &in[(i + num_verts - 1) % num_verts];
+        const LatLng *cur = &in[i];
+        bool prev_in = keep_above ? prev->lat >= bound : prev->lat <= bound;
+        bool cur_in = keep_above ? cur->lat >= bound : cur->lat <= bound;
+
+        if (cur_in != prev_in) {
+            out[count++] = lat_intersection(prev, cur, bound);
+        }
+        if (cur_in) {
+            out[count++] = *cur;
+        }
+    }
+
+    return count;
+}
+
+// Sutherland-Hodgman clip of a loop to the band south <= lat <= north. Runs on
+// worker threads, so the result is malloc'd.
+int geoloop_clip_lat(const GeoLoop *loop, double south, double north, GeoLoop *out)
+{
+    LatLng *tmp = malloc(sizeof(LatLng) * 2 * (loop->numVerts + 1));
+    LatLng *verts = malloc(sizeof(LatLng) * 4 * (loop->numVerts + 1));
+
+    if (!tmp || !verts) {
+        free(tmp);
+        free(verts);
+        return -1;
+    }
+
+    int count = clip_verts_lat(loop->verts, loop->numVerts, south, true, tmp);
+    count = clip_verts_lat(tmp, count, north, false, verts);
+    free(tmp);
+
+    out->numVerts = count;
+    out->verts = verts;
+
+    return 0;
+}
+
+// Band i of num_bands equal latitude bands over bbox. Cells are assigned to
+// the band their center falls in.
+void polyfill_band_init(h3_polyfill_task *task, const GeoPolygon *polygon, const h3_bbox *bbox, int res, int i, int num_bands)
+{
+    double step = (bbox->north - bbox->south) / num_bands;
+
+    task->polygon = polygon;
+    task->res = res;
+    task->min_center_lat = i == 0 ? -INFINITY : bbox->south + step * i;
+    task->max_center_lat = i == num_bands - 1 ? INFINITY : bbox->south + step * (i + 1);
+    task->south = (i == 0 ? bbox->south : task->min_center_lat) - H3_BAND_EPSILON;
+    task->north = (i == num_bands - 1 ? bbox->north : task->max_center_lat) + H3_BAND_EPSILON;
+}
+
+void polyfill_band_task(void *arg)
+{
+    h3_polyfill_task *task = arg;
+    const GeoPolygon *polygon = task->polygon;
+    GeoPolygon band = {0};
+    GeoLoop hole;
+    int64_t max = 0;
+    LatLng center;
+
+    task->cells = NULL;
+    task->num_cells = 0;
+    task->err = E_SUCCESS;
+
+    if (geoloop_clip_lat(&polygon->geoloop, task->south, task->north, &band.geoloop) != 0) {
+        task->err = E_MEMORY_ALLOC;
+        return;
+    }
+
+    if (band.geoloop.numVerts < 3) {
+        free(band.geoloop.verts);
+        return;
+    }
+
+    if (polygon->numHoles > 0) {
+        band.holes = malloc(sizeof(GeoLoop) * polygon->numHoles);
+        if (!band.holes) {
+            task->err = E_MEMORY_ALLOC;
+            goto cleanup;
+        }
+    }
+
+    for (int i = 0; i < polygon->numHoles; i++) {
+        if (geoloop_clip_lat(&polygon->holes[i], task->south, task->north, &hole) != 0) {
+            task->err = E_MEMORY_ALLOC;
+            goto cleanup;
+        }
+
+        if (hole.numVerts < 3) {
+            free(hole.verts);
+        } else {
+            band.holes[band.numHoles++] = hole;
+        }
+    }
+
+    task->err = maxPolygonToCellsSize(&band, task->res, 0, &max);
+    if (task->err) {
+        goto cleanup;
+    }
+
+    task->cells = calloc(max, sizeof(H3Index));
+    if (!task->cells) {
+        task->err = E_MEMORY_ALLOC;
+        goto cleanup;
+    }
+
+    task->err = polygonToCells(&band, task->res, 0, task->cells);
+    if (task->err) {
+        goto cleanup;
+    }
+
+    // bands overlap slightly, so each cell is kept only by the band its center falls in
+    for (int64_t i = 0; i < max; i++) {
+        if (task->cells[i] == H3_INVALID_INDEX || cellToLatLng(task->cells[i], &center)) {
+            continue;
+        }
+        if (center.lat >= task->min_center_lat && center.lat < task->max_center_lat) {
+            task->cells[task->num_cells++] = task->cells[i];
+        }
+    }
+
+cleanup:
+    free(band.geoloop.verts);
+    for (int i = 0; i < band.numHoles; i++) {
+        free(band.holes[i].verts);
+    }
+    free(band.holes);
+}
+
+// Splits the polygon into latitude bands that are polyfilled on the worker
+// pool. Returns the merged cells, or NULL with err set. Transmeridian polygons
+// are not supported, as libh3 does not fill their clipped bands consistently.
+H3Index *polyfill_parallel(const GeoPolygon *geo_polygon, const h3_bbox *bbox, int res, int threads, int64_t *num_cells, H3Error *err)
+{
+    int num_tasks = threads * H3_PARALLEL_TASKS_PER_THREAD;
+    h3_polyfill_task *tasks = ecalloc(num_tasks, sizeof(h3_polyfill_task));
+    H3Index *cells;
+
+    for (int i = 0; i < num_tasks; i++) {
+        polyfill_band_init(&tasks[i], geo_polygon, bbox, res, i, num_tasks);
+    }
+
+    h3_pool_run(polyfill_band_task, tasks, sizeof(h3_polyfill_task), num_tasks, threads);
+
+    *err = E_SUCCESS;
+    *num_cells = 0;
+    for (int i = 0; i < num_tasks; i++) {
+        if (tasks[i].err && !*err) {
+            *err = tasks[i].err;
+        }
+        *num_cells += tasks[i].num_cells;
+    }
+
+    cells = *err ? NULL : safe_emalloc(*num_cells, sizeof(H3Index), 0);
+    *num_cells = 0;
+
+    for (int i = 0; i < num_tasks; i++) {
+        if (cells && tasks[i].num_cells > 0) {
+            memcpy(cells + *num_cells, tasks[i].cells, tasks[i].num_cells * sizeof(H3Index));
+            *num_cells += tasks[i].num_cells;
+        }
+        free(tasks[i].cells);
+    }
+
+    efree(tasks);
+
+    return cells;
+}
+
+bool cells_share_res(const H3Index *cells, int64_t count)
+{
+    for (int64_t i = 1; i < count; i++) {
+        if (H3_GET_RES(cells[i]) != H3_GET_RES(cells[0])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// True for strictly increasing cells of a single resolution, like the output
+// of sort_cells() or unique_cells().
+bool cells_sorted_share_res(const H3Index *cells, int64_t count)
+{
+    for (int64_t i = 1; i < count; i++) {
+        if (cells[i] <= cells[i - 1] || H3_GET_RES(cells[i]) != H3_GET_RES(cells[0])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Pre-order key of the hierarchy: cells sort by their digits, with each cell
+// right before its descendants. For cells of one resolution this is the
+// order of their ids.
+uint64_t cell_hierarchy_key(H3Index cell)
+{
+    int res = H3_GET_RES(cell);
+
+    return ((cell & ((UINT64_C(1) << 52) - 1) & ~H3_DIGITS_BELOW(res)) << 4) | res;
+}
+
+// End of the run of siblings of resolution res starting at cells[i] in
+// hierarchy order, or i + 1 if cells[i] has another resolution.
+int64_t cells_sibling_run_end(const H3Index *cells, int64_t count, int64_t i, int res)
+{
+    uint64_t below = H3_DIGITS_BELOW(res - 1);
+    uint64_t prefix = ~(H3_RES_MASK | below);
+    int64_t end = i + 1;
+
+    if (H3_GET_RES(cells[i]) != res) {
+        return end;
+    }
+
+    while (end < count && end - i < 7 && H3_GET_RES(cells[end]) == res && ((cells[end] ^ cells[i]) & prefix) == 0) {
+        end++;
+    }
+
+    return end;
+}
+
+H3Index cell_parent_masked(H3Index cell, int res)
+{
+    uint64_t below = H3_DIGITS_BELOW(res);
+
+    return (cell & ~(H3_RES_MASK | below)) | ((uint64_t) res << 52) | below;
+}
+
+bool cell_contains(H3Index ancestor, H3Index cell)
+{
+    return H3_GET_RES(cell) >= H3_GET_RES(ancestor) && cell_parent_masked(cell, H3_GET_RES(ancestor)) == ancestor;
+}
+
+// Compacts cells in hierarchy order, such as input accepted by
+// cells_sorted_share_res(), in place, one resolution at a time, and returns
+// the number of cells left. Siblings are adjacent in this order and stay
+// adjacent when their parents replace them, so each level is a single pass
+// without lookups.
+int64_t compact_sorted_cells(H3Index *cells, int64_t count)
+{
+    int min_res = H3_MAX_RES;
+    int max_res = 0;
+
+    for (int64_t i = 0; i < count; i++) {
+        min_res = MIN(min_res, H3_GET_RES(cells[i]));
+        max_res = MAX(max_res, H3_GET_RES(cells[i]));
+    }
+
+    for (int res = max_res; res > 0; res--) {
+        int shift = (H3_MAX_RES - res) * 3;
+        int64_t kept = 0;
+        int64_t end;
+        bool compacted = false;
+        bool pentagon;
+        H3Index parent;
+
+        for (int64_t i = 0; i < count; i = end) {
+            end = cells_sibling_run_end(cells, count, i, res);
+            parent = cell_parent_masked(cells[i], res - 1);
+
+            // Children are distinct and ordered by digit, so checking the
+            // count and the first and last digits (and 2 following 0 under
+            // pentagons, which lack digit 1) proves the set is complete
+            pentagon = H3_IS_PENTAGON_BASE_CELL(H3_GET_BASE_CELL(parent)) && (parent & H3_DIGITS_MASK & ~H3_DIGITS_BELOW(res - 1)) == 0;
+            if (H3_GET_RES(cells[i]) == res && end - i == (pentagon ? 6 : 7) && ((cells[i] >> shift) & 7) == 0
+                && ((cells[end - 1] >> shift) & 7) == 6 && (!pentagon || ((cells[i + 1] >> shift) & 7) == 2)) {
+                cells[kept++] = parent;
+                compacted = true;
+            } else {
+                for (int64_t j = i; j < end; j++) {
+                    cells[kept++] = cells[j];
+                }
+            }
+        }
+
+        count = kept;
+
+        // Below the coarsest input resolution, parents can only come from
+        // parents made at the previous level
+        if (!compacted && res <= min_res) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+// Merges siblings of compacted cells in hierarchy order into their parents,
+// finest level first and the largest groups first, until at most budget cells
+// are left or no merge is possible. Each merge covers the missing siblings
+// too, so the result covers the input. Returns the number of cells left.
+int64_t cells_coarsen(H3Index *cells, int64_t count, int64_t budget)
+{
+    int max_res = 0;
+
+    for (int64_t i = 0; i < count; i++) {
+        max_res = MAX(max_res, H3_GET_RES(cells[i]));
+    }
+
+    for (int res = max_res; res > 0 && count > budget; res--) {
+        int64_t groups[8] = {0};
+        int64_t excess = count - budget;
+        int64_t partial = 0;
+        int64_t kept = 0;
+        int64_t end;
+        int size = 8;
+
+        for (int64_t i = 0; i < count; i = end) {
+            end = cells_sibling_run_end(cells, count, i, res);
+            if (H3_GET_RES(cells[i]) == res) {
+                groups[end - i]++;
+            }
+        }
+
+        // Merge every group larger than size, and just enough groups of
+        // exactly size to fit the budget. If that is not enough, lone cells
+        // are replaced by their parents too, so that coarser levels see only
+        // their resolution and coarser.
+        while (size > 1 && excess > 0) {
+            size--;
+            if (groups[size] * (size - 1) >= excess) {
+                partial = (excess + size - 2) / (size - 1);
+                excess = 0;
+            } else {
+                partial = groups[size];
+                excess -= groups[size] * (size - 1);
+            }
+        }
+
+        for (int64_t i = 0; i < count; i = end) {
+            end = cells_sibling_run_end(cells, count, i, res);
+            if (H3_GET_RES(cells[i]) == res && (end - i > size || (end - i == size && partial-- > 0))) {
+                cells[kept++] = cell_parent_masked(cells[i], res - 1);
+            } else {
+                for (int64_t j = i; j < end; j++) {
+                    cells[kept++] = cells[j];
+                }
+            }
+        }
+
+        count = kept;
+    }
+
+    return count;
+}
+
+// Sorts cells in hierarchy order and drops cells that repeat or lie inside
+// another cell of the set. Returns the number of cells kept.
+int64_t cells_normalize(H3Index *cells, int64_t count)
+{
+    uint64_t *keys = safe_emalloc(count, sizeof(uint64_t), 0);
+    int64_t kept = 0;
+
+    for (int64_t i = 0; i < count; i++) {
+        keys[i] = cell_hierarchy_key(cells[i]);
+    }
+    radix_sort(keys, cells, count);
+    efree(keys);
+
+    // Cells inside a kept cell follow it directly in hierarchy order
+    for (int64_t i = 0; i < count; i++) {
+        if (kept == 0 || !cell_contains(cells[kept - 1], cells[i])) {
+            cells[kept++] = cells[i];
+        }
+    }
+
+    return kept;
+}
+
+void compact_task(void *arg)
+{
+    h3_compact_task *task = arg;
+
+    task->err = compactCells(task->cells, task->out, task->num_cells);
+}
+
+// Compacts each base cell's cells on the worker pool; parents never span base
+// cells, so the buckets are independent. out must be zeroed and count long.
+H3Error compact_parallel(const H3Index *cells, int64_t count, H3Index *out, int threads)
+{
+    int64_t offsets[H3_NUM_BASE_CELLS_BITS + 1] = {0};
+    int64_t fill[H3_NUM_BASE_CELLS_BITS];
+    h3_compact_task tasks[H3_NUM_BASE_CELLS_BITS];
+    H3Index *sorted = safe_emalloc(count, sizeof(H3Index), 0);
+    int num_tasks = 0;
+    H3Error err = E_SUCCESS;
+
+    for (int64_t i = 0; i < count; i++) {
+        offsets[H3_GET_BASE_CELL(cells[i]) + 1]++;
+    }
+    for (int i = 0; i < H3_NUM_BASE_CELLS_BITS; i++) {
+        offsets[i + 1] += offsets[i];
+        fill[i] = offsets[i];
+    }
+    for (int64_t i = 0; i < count; i++) {
+        sorted[fill[H3_GET_BASE_CELL(cells[i])]++] = cells[i];
+    }
+
+    for (int i = 0; i < H3_NUM_BASE_CELLS_BITS; i++) {
+        if (offsets[i + 1] > offsets[i]) {
+            tasks[num_tasks].cells = sorted + offsets[i];
+            tasks[num_tasks].out = out + offsets[i];
+            tasks[num_tasks].num_cells = offsets[i + 1] - offsets[i];
+            num_tasks++;
+        }
+    }
+
+    h3_pool_run(compact_task, tasks, sizeof(h3_compact_task), num_tasks, threads);
+
+    for (int i = 0; i < num_tasks && !err; i++) {
+        err = tasks[i].err;
+    }
+
+    efree(sorted);
+
+    return err;
+}
+
+PHP_FUNCTION(degs_to_rads)
+{
+    double degrees;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_DOUBLE(degrees)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    RETURN_DOUBLE(degsToRads(degrees));
+}
+
+PHP_FUNCTION(rads_to_degs)
+{
+    double radians;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_DOUBLE(radians)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    RETURN_DOUBLE(radsToDegs(radians));
+}
+
+H3Error h3_tables_init(void)
+{
+    H3Error err;
+
+    if (res0CellCount() != H3_NUM_BASE_CELLS || pentagonCount() != H3_NUM_PENTAGONS) {
+        return E_FAILED;
+    }
+
+    err = getRes0Cells(h3_res0_cells);
+
+    for (int res = H3_MIN_RES; !err && res <= H3_MAX_RES; res++) {
+        h3_res_table *table = &h3_res_tables[res];
+
+        err = getHexagonAreaAvgKm2(res, &table->hex_area_km2);
+        err = err ? err : getHexagonAreaAvgM2(res, &table->hex_area_m2);
+        err = err ? err : getHexagonEdgeLengthAvgKm(res, &table->edge_length_km);
+        err = err ? err : getHexagonEdgeLengthAvgM(res, &table->edge_length_m);
+        err = err ? err : getNumCells(res, &table->num_cells);
+        err = err ? err : getPentagons(res, table->pentagons);
+    }
+
+    return err;
+}
+
+PHP_FUNCTION(hex_area)
+{
+    zend_long res;
+    zend_long unit;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_LONG(res)
+        Z_PARAM_LONG(unit)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    VALIDATE_H3_RES(res);
+
+    if (unit != H3_AREA_UNIT_KM2 && unit != H3_AREA_UNIT_M2) {
+        H3_THROW("Unsupported unit (must be one of H3_AREA_UNIT_KM2, or H3_AREA_UNIT_M2)",
+                 H3_ERR_CODE_UNSUPPORTED_UNIT);
+        RETURN_THROWS();
+    }
+
+    if (res < H3_MIN_RES || res > H3_MAX_RES) {
+        H3_THROW("Failed to get hex area", H3_ERR_CODE_INVALID_RES);
+        RETURN_THROWS();
+    }
+
+    RETURN_DOUBLE(unit == H3_AREA_UNIT_KM2 ? h3_res_tables[res].hex_area_km2 : h3_res_tables[res].hex_area_m2);
+}
+
+PHP_FUNCTION(edge_length)
+{
+    zend_long res;
+    zend_long unit;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_LONG(res)
+        Z_PARAM_LONG(unit)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    VALIDATE_H3_RES(res);
+
+    if (unit != H3_LENGTH_UNIT_KM && unit != H3_LENGTH_UNIT_M) {
+        H3_THROW("Unsupported unit (must be one of H3_LENGTH_UNIT_KM, or H3_LENGTH_UNIT_RADS)",
+                 H3_ERR_CODE_UNSUPPORTED_UNIT);
+        RETURN_THROWS();
+    }
+
+    if (res < H3_MIN_RES || res > H3_MAX_RES) {
+        H3_THROW("Failed to get edge length", H3_ERR_CODE_INVALID_RES);
+        RETURN_THROWS();
+    }
+
+    RETURN_DOUBLE(unit == H3_LENGTH_UNIT_KM ? h3_res_tables[res].edge_length_km : h3_res_tables[res].edge_length_m);
+}
+
+PHP_FUNCTION(num_hexagons)
+{
+    zend_long res;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(res)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    VALIDATE_H3_RES(res);
+
+    if (res < H3_MIN_RES || res > H3_MAX_RES) {
+        H3_THROW("Failed to get number of hexagons", H3_ERR_CODE_INVALID_RES);
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(h3_res_tables[res].num_cells);
+}
+
+PHP_FUNCTION(get_res0_indexes)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init_size(return_value, H3_NUM_BASE_CELLS);
+    h3_array_to_zend_array(h3_res0_cells, H3_NUM_BASE_CELLS, return_value);
+}
+
+PHP_FUNCTION(get_pentagon_indexes)
+{
+    zend_long res;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(res)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    VALIDATE_H3_RES(res);
+
+    if (res < H3_MIN_RES || res > H3_MAX_RES) {
+        H3_THROW("Failed to get pentagon indexes", H3_ERR_CODE_INVALID_RES);
+        RETURN_THROWS();
+    }
+
+    array_init_size(return_value, H3_NUM_PENTAGONS);
+    h3_array_to_zend_array(h3_res_tables[res].pentagons, H3_NUM_PENTAGONS, return_value);
+}
+
+PHP_FUNCTION(point_dist)
+{
+    zend_object *a;
+    zend_object *b;
+    zend_long unit;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_OBJ_OF_CLASS(a, H3_LatLng_ce)
+        Z_PARAM_OBJ_OF_CLASS(b, H3_LatLng_ce)
+        Z_PARAM_LONG(unit)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    LatLng geoA;
+    LatLng geoB;
+
+    obj_to_geo(a, &geoA);
+    obj_to_geo(b, &geoB);
+
+    switch (unit) {
+        case H3_LENGTH_UNIT_KM:
+            RETVAL_DOUBLE(greatCircleDistanceKm(&geoA, &geoB));
+            break;
+        case H3_LENGTH_UNIT_M:
+            RETVAL_DOUBLE(greatCircleDistanceM(&geoA, &geoB));
+            break;
+        case H3_LENGTH_UNIT_RADS:
+            RETVAL_DOUBLE(greatCircleDistanceRads(&geoA, &geoB));
+            break;
+        default:
+            H3_THROW("Unsupported unit (must be one of H3_LENGTH_UNIT_KM, H3_LENGTH_UNIT_M, or H3_LENGTH_UNIT_RADS)",
+                     H3_ERR_CODE_UNSUPPORTED_UNIT);
+            break;
+    }
+
+    if (Z_TYPE_P(return_value) == IS_NULL) {
+        RETURN_THROWS();
+    }
+}
+
+PHP_FUNCTION(compact)
+{
+    zval *indexes;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY(indexes)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    zend_array *arr = Z_ARR_P(indexes);
+    size_t count;
+    H3Index *set = h3_buffer_from_array_or_str(arr, NULL, &count);
+
+    if (!set) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers");
+        RETURN_THROWS();
+    }
+
+    // compactCells() rejects invalid cells, so the streaming path checks them
+    // up front as well
+    if (cells_sorted_share_res(set, count)) {
+        if (!cells_are_valid(set, count)) {
+            H3_THROW("Failed to compact", H3_ERR_CODE_COMPACT_ERROR);
+            efree(set);
+            RETURN_THROWS();
+        }
+
+        count = compact_sorted_cells(set, count);
+        array_init_size(return_value, count);
+        h3_array_to_zend_array(set, count, return_value);
+        efree(set);
+        return;
+    }
+
+    H3Index *compactedSet = ecalloc(count, sizeof(H3Index));
+    H3Error err;
+    int threads = h3_threads();
+
+    if (threads > 1 && count >= H3_PARALLEL_MIN_CELLS && cells_share_res(set, count)) {
+        err = compact_parallel(set, count, compactedSet, threads);
+    } else {
+        err = compactCells(set, compactedSet, count);
+    }
+
+    if (err) {
+        H3_THROW("Failed to compact", H3_ERR_CODE_COMPACT_ERROR);
+        efree(set);
+        efree(compactedSet);
+        RETURN_THROWS();
+    }
+
+    array_init(return_value);
+    h3_array_to_zend_array(compactedSet, count, return_value);
+
+    efree(set);
+    efree(compactedSet);
+}
+
+PHP_FUNCTION(uncompact)
+{
+    zval *indexes;
+    zend_long res;
+    zend_long output = H3_OUTPUT_LIST;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ARRAY(indexes)
+        Z_PARAM_LONG(res)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(output)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    VALIDATE_H3_RES(res);
+    VALIDATE_H3_OUTPUT(output, 3);
+
+    zend_array *arr = Z_ARR_P(indexes);
+    int count = zend_array_count(arr);
+    H3Index *compactedSet = ecalloc(count, sizeof(H3Index));
+
+    if (zend_array_to_h3_array(arr, compactedSet) != 0) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
+        efree(compactedSet);
+        RETURN_THROWS();
+    }
+
+    int64_t max;
+    H3Error err = uncompactCellsSize(compactedSet, count, res, &max);
+
+    if (err) {
+        H3_THROW("Unknown uncompact error", H3_ERR_CODE_UNCOMPACT_ERROR);
+        efree(compactedSet);
+        RETURN_THROWS();
+    }
+
+    H3Index *set = ecalloc(max, sizeof(H3Index));
+
+    err = uncompactCells(compactedSet, count, set, max, res);
+    if (err) {
+        H3_THROW("Failed to uncompact", H3_ERR_CODE_UNCOMPACT_ERROR);
+        efree(compactedSet);
+        efree(set);
+        RETURN_THROWS();
+    }
+
+    array_init(return_value);
+    h3_array_add_to_zval(set, max, output, return_value);
+
+    efree(compactedSet);
+    efree(set);
+}
+
+PHP_FUNCTION(line)
+{
+    zend_object *start;
+    zend_object *end;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJ_OF_CLASS(start, H3_H3Index_ce)
+        Z_PARAM_OBJ_OF_CLASS(end, H3_H3Index_ce)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    h3_line(start, end, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(distance)
+{
+    zend_object *a;
+    zend_object *b;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJ_OF_CLASS(a, H3_H3Index_ce)
+        Z_PARAM_OBJ_OF_CLASS(b, H3_H3Index_ce)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    int64_t dist;
+    H3Error err = gridDistance(obj_to_h3(a), obj_to_h3(b), &dist);
+    if (err) {
+        H3_THROW("Failed to calculate distance", 0);
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(dist);
+}
+
+PHP_FUNCTION(indexes_are_neighbors)
+{
+    zend_object *org;
+    zend_object *dest;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJ_OF_CLASS(org, H3_H3Index_ce)
+        Z_PARAM_OBJ_OF_CLASS(dest, H3_H3Index_ce)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    H3Index origin = obj_to_h3(org);
+    H3Index destination = obj_to_h3(dest);
+
+    int out;
+    H3Error err = areNeighborCells(origin, destination, &out);
+    if (err) {
+        H3_THROW("Failed to check neighbors", 0);
+        RETURN_THROWS();
+    }
+
+    RETURN_BOOL(out);
+}
+
+uint64_t h3_index_hash(H3Index index)
+{
+    index ^= index >> 33;
+    index *= 0xff51afd7ed558ccdULL;
+    index ^= index >> 33;
+
+    return index;
+}
+
+// Open addressing table of positions in cells, stored off by one so that zero
+// marks an empty slot. Duplicates keep their first position and are counted.
+int64_t *h3_index_table_build(const H3Index *cells, int64_t count, uint64_t *mask, int64_t *num_duplicates)
+{
+    uint64_t size = 16;
+    uint64_t slot;
+    int64_t *table;
+
+    while (size < (uint64_t) count * 2) {
+        size <<= 1;
+    }
+
+    *mask = size - 1;
+    *num_duplicates = 0;
+    table = ecalloc(size, sizeof(int64_t));
+
+    for (int64_t i = 0; i < count; i++) {
+        slot = h3_index_hash(cells[i]) & *mask;
+        while (table[slot] && cells[table[slot] - 1] != cells[i]) {
+            slot = (slot + 1) & *mask;
+        }
+        if (table[slot]) {
+            (*num_duplicates)++;
+        } else {
+            table[slot] = i + 1;
+        }
+    }
+
+    return table;
+}
+
+int64_t h3_index_table_find(const int64_t *table, uint64_t mask, const H3Index *cells, H3Index index)
+{
+    uint64_t slot = h3_index_hash(index) & mask;
+
+    while (table[slot]) {
+        if (cells[table[slot] - 1] == index) {
+            return table[slot] - 1;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+// Replaces cells with their distinct values in order of first appearance and
+// counts how often each occurred.
+size_t cells_count_distinct(H3Index *cells, size_t count, uint32_t *counts)
+{
+    uint64_t mask;
+    int64_t num_duplicates;
+    int64_t *table = h3_index_table_build(cells, count, &mask, &num_duplicates);
+    size_t num_distinct = 0;
+
+    memset(counts, 0, count * sizeof(uint32_t));
+    for (size_t i = 0; i < count; i++) {
+        counts[h3_index_table_find(table, mask, cells, cells[i])]++;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (counts[i]) {
+            cells[num_distinct] = cells[i];
+            counts[num_distinct++] = counts[i];
+        }
+    }
+
+    efree(table);
+
+    return num_distinct;
+}
+
+int64_t union_find_root(int64_t *parents, int64_t idx)
+{
+    while (parents[idx] != idx) {
+        parents[idx] = parents[parents[idx]];
+        idx = parents[idx];
+    }
+
+    return idx;
+}
+
+// Writes the positions after i of the cells within k of cells[i], padded with
+// -1 up to the disk size. Their grid distances are written too when
+// out_distances is given, using disk_distances as scratch.
+void cell_later_neighbors(const H3Index *cells, const int64_t *table, uint64_t mask, int64_t i, int k, H3Index *disk, int *disk_distances, int64_t disk_size, int32_t *out, int *out_distances)
+{
+    int64_t found;
+    int64_t num = 0;
+    H3Error err;
+
+    memset(disk, 0, disk_size * sizeof(H3Index));
+    if (out_distances) {
+        err = gridDiskDistances(cells[i], k, disk, disk_distances);
+    } else {
+        err = gridDisk(cells[i], k, disk);
+    }
+
+    if (err == E_SUCCESS) {
+        for (int64_t j = 0; j < disk_size; j++) {
+            if (disk[j] == H3_INVALID_INDEX || disk[j] == cells[i]) {
+                continue;
+            }
+            found = h3_index_table_find(table, mask, cells, disk[j]);
+            if (found > i) {
+                if (out_distances) {
+                    out_distances[num] = disk_distances[j];
+                }
+                out[num++] = (int32_t) found;
+            }
+        }
+    }
+
+    while (num < disk_size - 1) {
+        out[num++] = -1;
+    }
+}
+
+// The disk scratch is allocated by the caller, as workers must not use the
+// Zend allocator
+void neighbors_task(void *arg)
+{
+    h3_neighbors_task *task = arg;
+    int64_t width = task->disk_size - 1;
+
+    for (int64_t i = task->start; i < task->end; i++) {
+        cell_later_neighbors(task->cells, task->table, task->mask, i, task->k, task->disk, task->disk_distances,
+            task->disk_size, &task->neighbors[i * width], task->distances ? &task->distances[i * width] : NULL);
+    }
+}
+
+void union_find_merge(int64_t *parents, int64_t a, int64_t b)
+{
+    a = union_find_root(parents, a);
+    b = union_find_root(parents, b);
+    if (a != b) {
+        parents[MAX(a, b)] = MIN(a, b);
+    }
+}
+
+// Labels the components of cells connected within k steps. On return
+// components[i] is the smallest position in the component of cells[i].
+// Duplicates join the component of their first occurrence, or make the
+// result NULL unless allow_duplicates is set. Neighbour lookups run on the
+// worker pool when threads > 1 and k is at most 3.
+int64_t *cells_to_components(const H3Index *cells, int64_t count, int k, int threads, bool allow_duplicates)
+{
+    uint64_t mask;
+    int64_t num_duplicates;
+    int64_t disk_size;
+    int64_t *table;
+    int64_t *parents;
+    int32_t *neighbors;
+
+    if (maxGridDiskSize(k, &disk_size) != E_SUCCESS) {
+        return NULL;
+    }
+
+    table = h3_index_table_build(cells, count, &mask, &num_duplicates);
+    if (num_duplicates > 0 && !allow_duplicates) {
+        efree(table);
+        return NULL;
+    }
+
+    parents = safe_emalloc(count, sizeof(int64_t), 0);
+    for (int64_t i = 0; i < count; i++) {
+        parents[i] = i;
+    }
+
+    if (threads > 1 && count < INT32_MAX && disk_size - 1 <= H3_PARALLEL_MAX_NEIGHBORS) {
+        int num_tasks = threads * H3_PARALLEL_TASKS_PER_THREAD;
+        int64_t chunk = (count + num_tasks - 1) / num_tasks;
+        h3_neighbors_task *tasks = safe_emalloc(num_tasks, sizeof(h3_neighbors_task), 0);
+        H3Index *disks = safe_emalloc(num_tasks, disk_size * sizeof(H3Index), 0);
+
+        neighbors = safe_emalloc(count, (disk_size - 1) * sizeof(int32_t), 0);
+
+        for (int i = 0; i < num_tasks; i++) {
+            tasks[i].cells = cells;
+            tasks[i].table = table;
+            tasks[i].mask = mask;
+            tasks[i].k = k;
+            tasks[i].disk_size = disk_size;
+            tasks[i].disk = &disks[i * disk_size];
+            tasks[i].disk_distances = NULL;
+            tasks[i].neighbors = neighbors;
+            tasks[i].distances = NULL;
+            tasks[i].start = MIN(count, chunk * i);
+            tasks[i].end = MIN(count, chunk * (i + 1));
+        }
+
+        h3_pool_run(neighbors_task, tasks, sizeof(h3_neighbors_task), num_tasks, threads);
+        efree(disks);
+        efree(tasks);
+
+        for (int64_t i = 0; i < count; i++) {
+            int32_t *later = &neighbors[i * (disk_size - 1)];
+            for (int64_t j = 0; j < disk_size - 1 && later[j] >= 0; j++) {
+                union_find_merge(parents, i, later[j]);
+            }
+        }
+    } else {
+        H3Index *disk = safe_emalloc(disk_size, sizeof(H3Index), 0);
+
+        neighbors = safe_emalloc(disk_size, sizeof(int32_t), 0);
+
+        for (int64_t i = 0; i < count; i++) {
+            cell_later_neighbors(cells, table, mask, i, k, disk, NULL, disk_size, neighbors, NULL);
+            for (int64_t j = 0; j < disk_size - 1 && neighbors[j] >= 0; j++) {
+                union_find_merge(parents, i, neighbors[j]);
+            }
+        }
+
+        efree(disk);
+    }
+
+    efree(neighbors);
+
+    if (num_duplicates > 0) {
+        for (int64_t i = 0; i < count; i++) {
+            union_find_merge(parents, i, h3_index_table_find(table, mask, cells, cells[i]));
+        }
+    }
+
+    efree(table);
+
+    for (int64_t i = 0; i < count; i++) {
+        parents[i] = union_find_root(parents, i);
+    }
+
+    return parents;
+}
+
+// Adds weights[d] * values[j] to sums[i] and weights[d] to norms[i] for every
+// pair of cells i, j at grid distance d <= k. Each pair is looked up once from
+// its earlier cell and applied in both directions. The neighbour table is
+// filled on the worker pool when threads > 1 and k is at most 3.
+H3Error cells_convolve(const H3Index *cells, const double *values, int64_t count, int k, const double *weights, int threads, double *sums, double *norms)
+{
+    uint64_t mask;
+    int64_t num_duplicates;
+    int64_t disk_size;
+    int64_t width;
+    int64_t *table;
+    int32_t *neighbors;
+    int *distances;
+    H3Index *disk;
+    int *disk_distances;
+    bool cached;
+    H3Error err = maxGridDiskSize(k, &disk_size);
+
+    if (err) {
+        return err;
+    }
+
+    table = h3_index_table_build(cells, count, &mask, &num_duplicates);
+    if (num_duplicates > 0) {
+        efree(table);
+        return E_DUPLICATE_INPUT;
+    }
+
+    for (int64_t i = 0; i < count; i++) {
+        sums[i] = weights[0] * values[i];
+        norms[i] = weights[0];
+    }
+
+    width = disk_size - 1;
+    cached = threads > 1 && count < INT32_MAX && width <= H3_PARALLEL_MAX_NEIGHBORS;
+
+    if (cached) {
+        int num_tasks = threads * H3_PARALLEL_TASKS_PER_THREAD;
+        int64_t chunk = (count + num_tasks - 1) / num_tasks;
+        h3_neighbors_task *tasks = safe_emalloc(num_tasks, sizeof(h3_neighbors_task), 0);
+        H3Index *disks = safe_emalloc(num_tasks, disk_size * sizeof(H3Index), 0);
+
+        disk_distances = safe_emalloc(num_tasks, disk_size * sizeof(int), 0);
+        neighbors = safe_emalloc(count, width * sizeof(int32_t), 0);
+        distances = safe_emalloc(count, width * sizeof(int), 0);
+
+        for (int i = 0; i < num_tasks; i++) {
+            tasks[i].cells = cells;
+            tasks[i].table = table;
+            tasks[i].mask = mask;
+            tasks[i].k = k;
+            tasks[i].disk_size = disk_size;
+            tasks[i].disk = &disks[i * disk_size];
+            tasks[i].disk_distances = &disk_distances[i * disk_size];
+            tasks[i].neighbors = neighbors;
+            tasks[i].distances = distances;
+            tasks[i].start = MIN(count, chunk * i);
+            tasks[i].end = MIN(count, chunk * (i + 1));
+        }
+
+        h3_pool_run(neighbors_task, tasks, sizeof(h3_neighbors_task), num_tasks, threads);
+        efree(disks);
+        efree(disk_distances);
+        efree(tasks);
+    } else {
+        disk = safe_emalloc(disk_size, sizeof(H3Index), 0);
+        disk_distances = safe_emalloc(disk_size, sizeof(int), 0);
+        neighbors = safe_emalloc(disk_size, sizeof(int32_t), 0);
+        distances = safe_emalloc(disk_size, sizeof(int), 0);
+    }
+
+    for (int64_t i = 0; i < count; i++) {
+        int32_t *later = cached ? &neighbors[i * width] : neighbors;
+        int *later_distances = cached ? &distances[i * width] : distances;
+
+        if (!cached) {
+            cell_later_neighbors(cells, table, mask, i, k, disk, disk_distances, disk_size, later, later_distances);
+        }
+
+        for (int64_t j = 0; j < width && later[j] >= 0; j++) {
+            double weight = weights[later_distances[j]];
+            sums[i] += weight * values[later[j]];
+            norms[i] += weight;
+            sums[later[j]] += weight * values[i];
+            norms[later[j]] += weight;
+        }
+    }
+
+    if (!cached) {
+        efree(disk);
+        efree(disk_distances);
+    }
+    efree(neighbors);
+    efree(distances);
+    efree(table);
+
+    return E_SUCCESS;
+}
+
+void outline_task(void *arg)
+{
+    h3_outline_task *task = arg;
+
+    task->err = cellsToLinkedMultiPolygon(task->cells, task->num_cells, task->out);
+}
+
+// Traces the outlines of groups of whole connected components on the worker
+// pool. Components share no edges or vertices, so their outlines are exactly
+// those of the whole set, and the group results are chained into one list.
+H3Error cells_to_linked_multi_polygon_parallel(const H3Index *cells, int64_t count, int threads, LinkedGeoPolygon *out)
+{
+    int64_t *components = cells_to_components(cells, count, 1, threads, false);
+
+    if (!components) {
+        return cellsToLinkedMultiPolygon(cells, count, out);
+    }
+
+    int num_tasks = threads * H3_PARALLEL_TASKS_PER_THREAD;
+    int64_t chunk = (count + num_tasks - 1) / num_tasks;
+    int64_t *groups = ecalloc(count, sizeof(int64_t));
+    int64_t *offsets = ecalloc(num_tasks + 1, sizeof(int64_t));
+    H3Index *sorted = safe_emalloc(count, sizeof(H3Index), 0);
+    h3_outline_task *tasks = ecalloc(num_tasks, sizeof(h3_outline_task));
+    int64_t group_size = 0;
+    int64_t size;
+    int group = 0;
+    bool ran = false;
+    H3Error err = E_SUCCESS;
+    LinkedGeoPolygon *last = NULL;
+
+    for (int64_t i = 0; i < count; i++) {
+        groups[components[i]]++;
+    }
+
+    // a component's root is its first cell, so its size is read before any
+    // member needs its group
+    for (int64_t i = 0; i < count; i++) {
+        if (components[i] == i) {
+            size = groups[i];
+            if (group_size > 0 && group_size + size > chunk && group < num_tasks - 1) {
+                group++;
+                group_size = 0;
+            }
+            groups[i] = group;
+            group_size += size;
+        } else {
+            groups[i] = groups[components[i]];
+        }
+        offsets[groups[i] + 1]++;
+    }
+
+    for (int i = 0; i < num_tasks; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    for (int64_t i = 0; i < count; i++) {
+        sorted[offsets[groups[i]]++] = cells[i];
+    }
+    for (int i = num_tasks; i > 0; i--) {
+        offsets[i] = offsets[i - 1];
+    }
+    offsets[0] = 0;
+
+    efree(components);
+    efree(groups);
+
+    num_tasks = group + 1;
+    for (int i = 0; i < num_tasks; i++) {
+        tasks[i].cells = sorted + offsets[i];
+        tasks[i].num_cells = offsets[i + 1] - offsets[i];
+        tasks[i].out = i == 0 ? out : malloc(sizeof(LinkedGeoPolygon));
+        if (!tasks[i].out) {
+            err = E_MEMORY_ALLOC;
+        }
+    }
+
+    if (!err) {
+        h3_pool_run(outline_task, tasks, sizeof(h3_outline_task), num_tasks, threads);
+        ran = true;
+
+        for (int i = 0; i < num_tasks && !err; i++) {
+            err = tasks[i].err;
+        }
+    }
+
+    // polygons after the first are released with free() by destroyLinkedMultiPolygon
+    for (int i = 0; i < num_tasks; i++) {
+        if (!err) {
+            if (last) {
+                last->next = tasks[i].out;
+            }
+            for (last = tasks[i].out; last->next; last = last->next) {
+            }
+            continue;
+        }
+
+        if (ran && !tasks[i].err) {
+            destroyLinkedMultiPolygon(tasks[i].out);
+        }
+        if (i > 0) {
+            free(tasks[i].out);
+        }
+    }
+
+    efree(sorted);
+    efree(offsets);
+    efree(tasks);
+
+    return err;
+}
+
+H3Error cells_to_linked_multi_polygon(const H3Index *cells, int64_t count, LinkedGeoPolygon *out)
+{
+    int threads = h3_threads();
+
+    if (threads > 1 && count >= H3_PARALLEL_MIN_CELLS && cells_share_res(cells, count)) {
+        return cells_to_linked_multi_polygon_parallel(cells, count, threads, out);
+    }
+
+    return cellsToLinkedMultiPolygon(cells, count, out);
+}
+
+void h3_cell_list_push(h3_cell_list *list, H3Index cell)
+{
+    if (list->count == list->size) {
+        list->size = MAX(16, list->size * 2);
+        list->cells = safe_erealloc(list->cells, list->size, sizeof(H3Index), 0);
+    }
+
+    list->cells[list->count++] = cell;
+}
+
+void h3_cell_list_free(h3_cell_list *list)
+{
+    if (list->cells) {
+        efree(list->cells);
+    }
+}
+
+void h3_cell_set_init(h3_cell_set *set, int64_t capacity)
+{
+    uint64_t size = 16;
+
+    while (size < (uint64_t) capacity * 2) {
+        size <<= 1;
+    }
+
+    set->slots = ecalloc(size, sizeof(H3Index));
+    set->mask = size - 1;
+    set->count = 0;
+    set->resolutions = 0;
+}
+
+bool h3_cell_set_add(h3_cell_set *set, H3Index cell)
+{
+    uint64_t slot;
+
+    if ((uint64_t) (set->count + 1) * 2 > set->mask + 1) {
+        H3Index *old = set->slots;
+        uint64_t old_size = set->mask + 1;
+
+        set->slots = ecalloc(old_size * 2, sizeof(H3Index));
+        set->mask = old_size * 2 - 1;
+
+        for (uint64_t i = 0; i < old_size; i++) {
+            if (old[i]) {
+                slot = h3_index_hash(old[i]) & set->mask;
+                while (set->slots[slot]) {
+                    slot = (slot + 1) & set->mask;
+                }
+                set->slots[slot] = old[i];
+            }
+        }
+
+        efree(old);
+    }
+
+    slot = h3_index_hash(cell) & set->mask;
+    while (set->slots[slot]) {
+        if (set->slots[slot] == cell) {
+            return false;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+
+    set->slots[slot] = cell;
+    set->count++;
+    set->resolutions |= 1u << H3_GET_RES(cell);
+
+    return true;
+}
+
+bool h3_cell_set_has(const h3_cell_set *set, H3Index cell)
+{
+    uint64_t slot = h3_index_hash(cell) & set->mask;
+
+    while (set->slots[slot]) {
+        if (set->slots[slot] == cell) {
+            return true;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+
+    return false;
+}
+
+// Whether cell or one of its ancestors down to max_res is in the set.
+bool h3_cell_set_covers(const h3_cell_set *set, H3Index cell, int max_res)
+{
+    H3Index parent;
+
+    for (int res = MIN(H3_GET_RES(cell), max_res); res >= 0; res--) {
+        if ((set->resolutions & (1u << res)) && cellToParent(cell, res, &parent) == E_SUCCESS
+            && h3_cell_set_has(set, parent)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void h3_cell_set_free(h3_cell_set *set)
+{
+    efree(set->slots);
+}
+
+bool h3_cell_set_covers_disk(const h3_cell_set *set, H3Index cell, int k, H3Index *disk, int64_t disk_size)
+{
+    memset(disk, 0, disk_size * sizeof(H3Index));
+    if (gridDisk(cell, k, disk) != E_SUCCESS) {
+        return false;
+    }
+
+    for (int64_t i = 0; i < disk_size; i++) {
+        if (disk[i] != H3_INVALID_INDEX && !h3_cell_set_covers(set, disk[i], H3_MAX_RES)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// compactCells() wants a single resolution, so cells are compacted one
+// resolution at a time from the finest, with parents carried down to join
+// their coarser siblings.
+H3Error compact_mixed_cells(const H3Index *cells, int64_t count, h3_cell_list *out)
+{
+    h3_cell_list levels[H3_MAX_RES + 1] = {0};
+    H3Index *compacted;
+    H3Error err = E_SUCCESS;
+    int res;
+
+    for (int64_t i = 0; i < count; i++) {
+        h3_cell_list_push(&levels[H3_GET_RES(cells[i])], cells[i]);
+    }
+
+    for (int r = H3_MAX_RES; r >= 0; r--) {
+        if (levels[r].count == 0 || err) {
+            h3_cell_list_free(&levels[r]);
+            continue;
+        }
+
+        compacted = ecalloc(levels[r].count, sizeof(H3Index));
+        err = compactCells(levels[r].cells, compacted, levels[r].count);
+
+        for (int64_t i = 0; !err && i < levels[r].count; i++) {
+            if (compacted[i] != H3_INVALID_INDEX) {
+                res = H3_GET_RES(compacted[i]);
+                h3_cell_list_push(res == r ? out : &levels[res], compacted[i]);
+            }
+        }
+
+        efree(compacted);
+        h3_cell_list_free(&levels[r]);
+    }
+
+    return err;
+}
+
+// Appends the parts of cell outside holes, the normalized cells of another
+// set that lie inside it, splitting cell only where it contains a hole.
+void cell_subtract(H3Index cell, const H3Index *holes, int64_t num_holes, h3_cell_list *out)
+{
+    int res = H3_GET_RES(cell) + 1;
+    int shift = (H3_MAX_RES - res) * 3;
+    bool pentagon = H3_IS_PENTAGON_BASE_CELL(H3_GET_BASE_CELL(cell)) && (cell & H3_DIGITS_MASK & ~H3_DIGITS_BELOW(res - 1)) == 0;
+    int64_t start = 0;
+    int64_t end;
+    H3Index child;
+
+    if (num_holes == 0) {
+        h3_cell_list_push(out, cell);
+        return;
+    }
+
+    // A hole covering cell sorts first
+    if (holes[0] == cell) {
+        return;
+    }
+
+    for (int digit = 0; digit < 7; digit++) {
+        if (pentagon && digit == 1) {
+            continue;
+        }
+
+        child = (cell & ~(H3_RES_MASK | (UINT64_C(7) << shift))) | ((uint64_t) res << 52) | ((uint64_t) digit << shift);
+        end = start;
+        while (end < num_holes && cell_contains(child, holes[end])) {
+            end++;
+        }
+
+        cell_subtract(child, holes + start, end - start, out);
+        start = end;
+    }
+}
+
+// Combines two normalized sets into out in hierarchy order. The result is
+// not compacted yet.
+void cells_set_operation(int op, const H3Index *a, int64_t num_a, const H3Index *b, int64_t num_b, h3_cell_list *out)
+{
+    int64_t i = 0;
+    int64_t j = 0;
+    int64_t end;
+
+    while (i < num_a && j < num_b) {
+        if (cell_contains(a[i], b[j])) {
+            if (op == H3_SET_UNION) {
+                h3_cell_list_push(out, a[i]);
+                while (j < num_b && cell_contains(a[i], b[j])) {
+                    j++;
+                }
+                i++;
+            } else if (op == H3_SET_INTERSECTION) {
+                h3_cell_list_push(out, b[j++]);
+            } else {
+                end = j;
+                while (end < num_b && cell_contains(a[i], b[end])) {
+                    end++;
+                }
+                cell_subtract(a[i++], b + j, end - j, out);
+                j = end;
+            }
+        } else if (cell_contains(b[j], a[i])) {
+            if (op == H3_SET_UNION) {
+                h3_cell_list_push(out, b[j]);
+                while (i < num_a && cell_contains(b[j], a[i])) {
+                    i++;
+                }
+                j++;
+            } else if (op == H3_SET_INTERSECTION) {
+                h3_cell_list_push(out, a[i++]);
+            } else {
+                i++;
+            }
+        } else if (cell_hierarchy_key(a[i]) < cell_hierarchy_key(b[j])) {
+            if (op != H3_SET_INTERSECTION) {
+                h3_cell_list_push(out, a[i]);
+            }
+            i++;
+        } else {
+            if (op == H3_SET_UNION) {
+                h3_cell_list_push(out, b[j]);
+            }
+            j++;
+        }
+    }
+
+    for (; op != H3_SET_INTERSECTION && i < num_a; i++) {
+        h3_cell_list_push(out, a[i]);
+    }
+    for (; op == H3_SET_UNION && j < num_b; j++) {
+        h3_cell_list_push(out, b[j]);
+    }
+}
+
+// True when every cell of b lies inside a cell of a. Both are normalized and
+// a is compacted; the only cell of a that can contain b[j] is the last one
+// sorting before it.
+bool cells_set_contains(const H3Index *a, int64_t num_a, const H3Index *b, int64_t num_b)
+{
+    int64_t i = 0;
+
+    for (int64_t j = 0; j < num_b; j++) {
+        while (i + 1 < num_a && cell_hierarchy_key(a[i + 1]) <= cell_hierarchy_key(b[j])) {
+            i++;
+        }
+        if (num_a == 0 || !cell_contains(a[i], b[j])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Builds the compacted set of cells, dropping duplicates and cells already
+// covered by one of their ancestors. res is set to the finest resolution.
+H3Error cells_to_compact_set(const H3Index *cells, int64_t count, h3_cell_set *set, int *res)
+{
+    h3_cell_set all;
+    h3_cell_list unique = {0};
+    h3_cell_list compacted = {0};
+    H3Error err;
+
+    *res = 0;
+    h3_cell_set_init(&all, count);
+
+    for (int64_t i = 0; i < count; i++) {
+        if (!isValidCell(cells[i])) {
+            h3_cell_set_free(&all);
+            return E_CELL_INVALID;
+        }
+        h3_cell_set_add(&all, cells[i]);
+        *res = MAX(*res, H3_GET_RES(cells[i]));
+    }
+
+    for (uint64_t i = 0; i <= all.mask; i++) {
+        if (all.slots[i] && !h3_cell_set_covers(&all, all.slots[i], H3_GET_RES(all.slots[i]) - 1)) {
+            h3_cell_list_push(&unique, all.slots[i]);
+        }
+    }
+
+    h3_cell_set_free(&all);
+
+    err = compact_mixed_cells(unique.cells, unique.count, &compacted);
+    h3_cell_list_free(&unique);
+
+    h3_cell_set_init(set, compacted.count);
+    for (int64_t i = 0; !err && i < compacted.count; i++) {
+        h3_cell_set_add(set, compacted.cells[i]);
+    }
+
+    h3_cell_list_free(&compacted);
+
+    if (err) {
+        h3_cell_set_free(set);
+    }
+
+    return err;
+}
+
+// Splits the cells of set until each either has its whole k-disk covered by
+// the set or is at res. Descendants of a cell only neighbour descendants of
+// the cell and its neighbours, so a disk covered at a coarse resolution stays
+// covered at every finer one and interior cells are never split.
+H3Error cell_set_refine(const h3_cell_set *set, int k, int res, h3_cell_list *covered, h3_cell_list *exposed)
+{
+    h3_cell_list stack = {0};
+    H3Index children[7];
+    H3Index *disk;
+    int64_t disk_size;
+    int64_t num_children;
+    H3Index cell;
+    H3Error err = maxGridDiskSize(k, &disk_size);
+
+    if (err) {
+        return err;
+    }
+
+    disk = safe_emalloc(disk_size, sizeof(H3Index), 0);
+
+    for (uint64_t i = 0; i <= set->mask; i++) {
+        if (!set->slots[i]) {
+            continue;
+        }
+
+        h3_cell_list_push(&stack, set->slots[i]);
+
+        while (stack.count > 0) {
+            cell = stack.cells[--stack.count];
+
+            if (h3_cell_set_covers_disk(set, cell, k, disk, disk_size)) {
+                h3_cell_list_push(covered, cell);
+            } else if (H3_GET_RES(cell) == res) {
+                h3_cell_list_push(exposed, cell);
+            } else {
+                memset(children, 0, sizeof(children));
+                cellToChildrenSize(cell, H3_GET_RES(cell) + 1, &num_children);
+                cellToChildren(cell, H3_GET_RES(cell) + 1, children);
+                for (int64_t j = 0; j < num_children; j++) {
+                    h3_cell_list_push(&stack, children[j]);
+                }
+            }
+        }
+    }
+
+    efree(disk);
+    h3_cell_list_free(&stack);
+
+    return E_SUCCESS;
+}
+
+// Grows the set by k rings at res. Only cells exposed to the outside are
+// expanded, and each later ring only from the cells the previous one added.
+H3Error cell_set_dilate(const h3_cell_set *set, int k, int res, h3_cell_list *out)
+{
+    h3_cell_list exposed = {0};
+    h3_cell_list next = {0};
+    h3_cell_list swap;
+    h3_cell_set added;
+    H3Index disk[7];
+    H3Error err = cell_set_refine(set, 1, res, out, &exposed);
+
+    if (err) {
+        return err;
+    }
+
+    for (int64_t i = 0; i < exposed.count; i++) {
+        h3_cell_list_push(out, exposed.cells[i]);
+    }
+
+    // Sized for the first ring and grown as later rings are added
+    h3_cell_set_init(&added, exposed.count);
+
+    for (int step = 0; step < k && exposed.count > 0; step++) {
+        next.count = 0;
+
+        for (int64_t i = 0; i < exposed.count; i++) {
+            memset(disk, 0, sizeof(disk));
+            gridDisk(exposed.cells[i], 1, disk);
+            for (int j = 0; j < 7; j++) {
+                if (disk[j] != H3_INVALID_INDEX && !h3_cell_set_covers(set, disk[j], H3_MAX_RES)
+                    && h3_cell_set_add(&added, disk[j])) {
+                    h3_cell_list_push(&next, disk[j]);
+                    h3_cell_list_push(out, disk[j]);
+                }
+            }
+        }
+
+        swap = exposed;
+        exposed = next;
+        next = swap;
+    }
+
+    h3_cell_list_free(&exposed);
+    h3_cell_list_free(&next);
+    h3_cell_set_free(&added);
+
+    return E_SUCCESS;
+}
+
+// Polyfills the polygons at res into out, giving up once it holds more than
+// limit cells. Polygons whose size estimate exceeds what is left of the limit
+// are filled band by band, so that the abort comes early.
+H3Error polyfill_with_limit(const GeoPolygon *polygons, const h3_bbox *bboxes, int num_polygons, int res, int64_t limit, h3_cell_list *out)
+{
+    int64_t max;
+    H3Error err;
+
+    for (int p = 0; p < num_polygons && out->count <= limit; p++) {
+        err = maxPolygonToCellsSize(&polygons[p], res, 0, &max);
+        if (err) {
+            return err;
+        }
+
+        if (max <= limit - out->count || bboxes[p].east < bboxes[p].west) {
+            H3Index *cells = ecalloc(max, sizeof(H3Index));
+
+            err = polygonToCells(&polygons[p], res, 0, cells);
+            for (int64_t i = 0; !err && i < max; i++) {
+                if (cells[i] != H3_INVALID_INDEX) {
+                    h3_cell_list_push(out, cells[i]);
+                }
+            }
+            efree(cells);
+
+            if (err) {
+                return err;
+            }
+            continue;
+        }
+
+        for (int i = 0; i < H3_BUDGET_BANDS && out->count <= limit; i++) {
+            h3_polyfill_task task;
+
+            polyfill_band_init(&task, &polygons[p], &bboxes[p], res, i, H3_BUDGET_BANDS);
+            polyfill_band_task(&task);
+
+            for (int64_t j = 0; j < task.num_cells; j++) {
+                h3_cell_list_push(out, task.cells[j]);
+            }
+            free(task.cells);
+
+            if (task.err) {
+                return task.err;
+            }
+        }
+    }
+
+    return E_SUCCESS;
+}
+
+// Polyfills at the finest resolution whose cells fit in budget. With mixed,
+// finer resolutions are tried too: their cells are compacted and, if still
+// too many, coarsened to fit. Leaves more than budget cells in out when not
+// even resolution 0 fits.
+H3Error polyfill_budget_cells(const GeoPolygon *polygons, const h3_bbox *bboxes, int num_polygons, int64_t budget, bool mixed, h3_cell_list *out)
+{
+    h3_cell_list next = {0};
+    h3_cell_list swap;
+    int64_t limit = budget;
+    int64_t max;
+    int64_t total;
+    int res = H3_MIN_RES;
+    bool fits;
+    H3Error err;
+
+    if (mixed) {
+        limit = budget > INT64_MAX / H3_BUDGET_OVERFILL ? INT64_MAX : budget * H3_BUDGET_OVERFILL;
+    }
+
+    // Size estimates are upper bounds, so the finest resolution whose
+    // estimate fits is a safe place to start
+    for (int r = H3_MIN_RES; r <= H3_MAX_RES; r++) {
+        total = 0;
+        for (int i = 0; i < num_polygons && total <= budget; i++) {
+            err = maxPolygonToCellsSize(&polygons[i], r, 0, &max);
+            if (err) {
+                return err;
+            }
+            total += max;
+        }
+
+        if (total > budget) {
+            break;
+        }
+        res = r;
+    }
+
+    err = polyfill_with_limit(polygons, bboxes, num_polygons, res, budget, out);
+
+    // Normalized like the finer fills, in case none of them fits
+    if (!err && mixed) {
+        out->count = compact_sorted_cells(out->cells, cells_normalize(out->cells, out->count));
+    }
+
+    while (!err && out->count <= budget && ++res <= H3_MAX_RES) {
+        next.count = 0;
+        err = polyfill_with_limit(polygons, bboxes, num_polygons, res, limit, &next);
+        if (err || next.count > limit) {
+            break;
+        }
+
+        if (mixed) {
+            next.count = compact_sorted_cells(next.cells, cells_normalize(next.cells, next.count));
+        }
+
+        fits = next.count <= budget;
+        if (!fits) {
+            next.count = cells_coarsen(next.cells, next.count, budget);
+        }
+
+        if (next.count <= budget) {
+            swap = *out;
+            *out = next;
+            next = swap;
+        }
+
+        if (!fits) {
+            break;
+        }
+    }
+
+    h3_cell_list_free(&next);
+
+    return err;
+}
+
+size_t geoloop_cache_key(const GeoLoop *loop, char *out)
+{
+    size_t size = sizeof(int) + sizeof(LatLng) * loop->numVerts;
+
+    if (out) {
+        memcpy(out, &loop->numVerts, sizeof(int));
+        memcpy(out + sizeof(int), loop->verts, sizeof(LatLng) * loop->numVerts);
+    }
+
+    return size;
+}
+
+// The raw coordinates, resolution and flags, so equal keys mean equal results
+zend_string *polyfill_cache_key(const GeoPolygon *polygon, int res, uint32_t flags)
+{
+    size_t size = sizeof(int) * 2 + sizeof(uint32_t) + geoloop_cache_key(&polygon->geoloop, NULL);
+    zend_string *key;
+    char *p;
+
+    for (int i = 0; i < polygon->numHoles; i++) {
+        size += geoloop_cache_key(&polygon->holes[i], NULL);
+    }
+
+    key = zend_string_alloc(size, 0);
+    p = ZSTR_VAL(key);
+
+    memcpy(p, &res, sizeof(int));
+    memcpy(p + sizeof(int), &flags, sizeof(uint32_t));
+    memcpy(p + sizeof(int) + sizeof(uint32_t), &polygon->numHoles, sizeof(int));
+    p += sizeof(int) * 2 + sizeof(uint32_t);
+
+    p += geoloop_cache_key(&polygon->geoloop, p);
+    for (int i = 0; i < polygon->numHoles; i++) {
+        p += geoloop_cache_key(&polygon->holes[i], p);
+    }
+    *p = '\0';
+
+    return key;
+}
+
+void h3_result_cache_remove(h3_result_cache_entry *entry)
+{
+    zend_hash_del(H3_G(result_cache), entry->key);
+    H3_G(result_cache_bytes) -= entry->size;
+    zend_string_release(entry->key);
+    pefree(entry, 1);
+}
+
+void h3_result_cache_free(HashTable *cache)
+{
+    h3_result_cache_entry *entry;
+
+    ZEND_HASH_FOREACH_PTR(cache, entry)
+    {
+        zend_string_release(entry->key);
+        pefree(entry, 1);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    zend_hash_destroy(cache);
+    pefree(cache, 1);
+}
+
+// Looks key up and marks the entry as most recently used
+h3_result_cache_entry *h3_result_cache_find(zend_string *key)
+{
+    h3_result_cache_entry *entry = H3_G(result_cache) ? zend_hash_find_ptr(H3_G(result_cache), key) : NULL;
+
+    if (!entry) {
+        H3_G(result_cache_misses)++;
+        return NULL;
+    }
+
+    H3_G(result_cache_hits)++;
+
+    // Entries are kept in insertion order, so re-adding moves it to the end
+    zend_hash_del(H3_G(result_cache), entry->key);
+    zend_hash_add_new_ptr(H3_G(result_cache), entry->key, entry);
+
+    return entry;
+}
+
+// Stores cells, skipping invalid ones, under key. The least recently used
+// entries are evicted to stay within h3.result_cache_size bytes.
+void h3_result_cache_add(zend_string *key, const H3Index *cells, int64_t num_cells)
+{
+    h3_result_cache_entry *entry;
+    int64_t count = 0;
+    size_t size;
+
+    for (int64_t i = 0; i < num_cells; i++) {
+        count += cells[i] != H3_INVALID_INDEX;
+    }
+
+    size = sizeof(h3_result_cache_entry) + sizeof(H3Index) * count + ZSTR_LEN(key);
+    if (size > (size_t) H3_G(result_cache_size)) {
+        return;
+    }
+
+    if (!H3_G(result_cache)) {
+        H3_G(result_cache) = pemalloc(sizeof(HashTable), 1);
+        zend_hash_init(H3_G(result_cache), 16, NULL, NULL, 1);
+    }
+
+    while (H3_G(result_cache_bytes) + size > (size_t) H3_G(result_cache_size)) {
+        ZEND_HASH_FOREACH_PTR(H3_G(result_cache), entry)
+        {
+            break;
+        }
+        ZEND_HASH_FOREACH_END();
+
+        h3_result_cache_remove(entry);
+        H3_G(result_cache_evictions)++;
+    }
+
+    entry = pemalloc(sizeof(h3_result_cache_entry) + sizeof(H3Index) * count, 1);
+    entry->key = zend_string_init(ZSTR_VAL(key), ZSTR_LEN(key), 1);
+    entry->size = size;
+    entry->count = 0;
+
+    for (int64_t i = 0; i < num_cells; i++) {
+        if (cells[i] != H3_INVALID_INDEX) {
+            entry->cells[entry->count++] = cells[i];
+        }
+    }
+
+    zend_hash_add_new_ptr(H3_G(result_cache), entry->key, entry);
+    H3_G(result_cache_bytes) += size;
+}
+
+int polyfill_geopolygon(const GeoPolygon *geo_polygon, const h3_bbox *bbox, zend_long res, zend_long output, zval *return_value)
+{
+    int64_t max;
+    int threads = h3_threads();
+    h3_bbox loop_bbox;
+    zend_string *key = NULL;
+    h3_result_cache_entry *entry;
+    bool parallel;
+
+    H3Error err = maxPolygonToCellsSize(geo_polygon, res, 0, &max);
+    if (err) {
+        H3_THROW("Failed to calculate polyfill size", 0);
+        return -1;
+    }
+
+    if (threads > 1 && max >= H3_PARALLEL_MIN_CELLS && !bbox) {
+        geoloop_to_bbox(&geo_polygon->geoloop, &loop_bbox);
+        bbox = &loop_bbox;
+    }
+
+    parallel = threads > 1 && max >= H3_PARALLEL_MIN_CELLS && bbox->east >= bbox->west;
+
+    // The serial and parallel fills order cells differently, so they are
+    // cached apart and a hit returns the order a miss would have
+    if (H3_G(result_cache_size) > 0) {
+        key = polyfill_cache_key(geo_polygon, res, parallel ? H3_CACHE_KEY_PARALLEL : 0);
+        entry = h3_result_cache_find(key);
+
+        if (entry) {
+            h3_array_add_to_zval(entry->cells, entry->count, output, return_value);
+            zend_string_release(key);
+            return 0;
+        }
+    }
+
+    if (parallel) {
+        H3Index *cells = polyfill_parallel(geo_polygon, bbox, res, threads, &max, &err);
+        if (err) {
+            if (key) {
+                zend_string_release(key);
+            }
+            H3_THROW("Failed to polyfill", 0);
+            return -1;
+        }
+
+        if (key) {
+            h3_result_cache_add(key, cells, max);
+            zend_string_release(key);
+        }
+
+        h3_array_add_to_zval(cells, max, output, return_value);
+        efree(cells);
+
+        return 0;
+    }
+
+    H3Index *out = ecalloc(max, sizeof(H3Index));
+    err = polygonToCells(geo_polygon, res, 0, out);
+    if (err) {
+        efree(out);
+        if (key) {
+            zend_string_release(key);
+        }
+        H3_THROW("Failed to polyfill", 0);
+        return -1;
+    }
+
+    if (key) {
+        h3_result_cache_add(key, out, max);
+        zend_string_release(key);
+    }
+
+    h3_array_add_to_zval(out, max, output, return_value);
+
+    efree(out);
+
+    return 0;
+}
+
+PHP_FUNCTION(polyfill)
+{
+    zval *polygon;
+    zend_long res;
+    zend_long output = H3_OUTPUT_LIST;
+    zval result;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ZVAL(polygon)
+        Z_PARAM_LONG(res)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(output)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    if (!OBJ_IS_A(polygon, H3_GeoPolygon_ce) && Z_TYPE_P(polygon) != IS_ARRAY) {
+        zend_argument_type_error(1, "must be of type H3\\GeoPolygon|array, %s given", zend_zval_type_name(polygon));
+        RETURN_THROWS();
+    }
+
+    VALIDATE_H3_RES(res);
+    VALIDATE_H3_OUTPUT(output, 3);
+
+    if (Z_TYPE_P(polygon) == IS_OBJECT) {
+        const h3_bbox *bbox;
+        const GeoPolygon *geo_polygon = obj_to_geopolygon(Z_OBJ_P(polygon), &bbox);
+
+        if (!geo_polygon) {
+            zend_argument_error(H3_H3Exception_ce, 1, "must be valid GeoPolygon object");
+            RETURN_THROWS();
+        }
+
+        array_init(&result);
+        if (polyfill_geopolygon(geo_polygon, bbox, res, output, &result) != 0) {
+            zval_ptr_dtor(&result);
+            RETURN_THROWS();
+        }
+
+        RETURN_COPY_VALUE(&result);
+    }
+
+    GeoPolygon *geo_polygons;
+    int num_polygons = geo_json_to_geopolygons(Z_ARR_P(polygon), &geo_polygons);
+
+    if (num_polygons < 0) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be a GeoJSON Polygon or MultiPolygon, or a flat array of coordinates");
+        RETURN_THROWS();
+    }
+
+    array_init(&result);
+
+    for (int i = 0; i < num_polygons; i++) {
+        if (!EG(exception)) {
+            polyfill_geopolygon(&geo_polygons[i], NULL, res, output, &result);
+        }
+        geopolygon_free(&geo_polygons[i]);
+    }
+
+    efree(geo_polygons);
+
+    if (EG(exception)) {
+        zval_ptr_dtor(&result);
+        RETURN_THROWS();
+    }
+
+    RETURN_COPY_VALUE(&result);
+}
+
+PHP_FUNCTION(result_cache_stats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init_size(return_value, 6);
+    add_assoc_long(return_value, "entries", H3_G(result_cache) ? zend_hash_num_elements(H3_G(result_cache)) : 0);
+    add_assoc_long(return_value, "bytes", H3_G(result_cache_bytes));
+    add_assoc_long(return_value, "max_bytes", H3_G(result_cache_size));
+    add_assoc_long(return_value, "hits", H3_G(result_cache_hits));
+    add_assoc_long(return_value, "misses", H3_G(result_cache_misses));
+    add_assoc_long(return_value, "evictions", H3_G(result_cache_evictions));
+}
+
+PHP_FUNCTION(result_cache_clear)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (H3_G(result_cache)) {
+        h3_result_cache_free(H3_G(result_cache));
+        H3_G(result_cache) = NULL;
+    }
+
+    H3_G(result_cache_bytes) = 0;
+    H3_G(result_cache_hits) = 0;
+    H3_G(result_cache_misses) = 0;
+    H3_G(result_cache_evictions) = 0;
+}
+
+PHP_FUNCTION(polyfill_budget)
+{
+    zval *polygon;
+    zend_long max_cells;
+    bool mixed = false;
+    GeoPolygon *geo_polygons = NULL;
+    const GeoPolygon *polygons;
+    const h3_bbox *bbox;
+    h3_bbox *bboxes = NULL;
+    int num_polygons = 1;
+    h3_cell_list cells = {0};
+    H3Error err;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ZVAL(polygon)
+        Z_PARAM_LONG(max_cells)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(mixed)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    if (!OBJ_IS_A(polygon, H3_GeoPolygon_ce) && Z_TYPE_P(polygon) != IS_ARRAY) {
+        zend_argument_type_error(1, "must be of type H3\\GeoPolygon|array, %s given", zend_zval_type_name(polygon));
+        RETURN_THROWS();
+    }
+
+    if (max_cells < 1) {
+        zend_argument_value_error(2, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    if (Z_TYPE_P(polygon) == IS_OBJECT) {
+        polygons = obj_to_geopolygon(Z_OBJ_P(polygon), &bbox);
+
+        if (!polygons) {
+            zend_argument_error(H3_H3Exception_ce, 1, "must be valid GeoPolygon object");
+            RETURN_THROWS();
+        }
+    } else {
+        num_polygons = geo_json_to_geopolygons(Z_ARR_P(polygon), &geo_polygons);
+
+        if (num_polygons < 0) {
+            zend_argument_error(H3_H3Exception_ce, 1, "must be a GeoJSON Polygon or MultiPolygon, or a flat array of coordinates");
+            RETURN_THROWS();
+        }
+
+        bboxes = safe_emalloc(num_polygons, sizeof(h3_bbox), 0);
+        for (int i = 0; i < num_polygons; i++) {
+            geoloop_to_bbox(&geo_polygons[i].geoloop, &bboxes[i]);
+        }
+
+        polygons = geo_polygons;
+        bbox = bboxes;
+    }
+
+    err = polyfill_budget_cells(polygons, bbox, num_polygons, max_cells, mixed, &cells);
+
+    if (geo_polygons) {
+        for (int i = 0; i < num_polygons; i++) {
+            geopolygon_free(&geo_polygons[i]);
+        }
+        efree(geo_polygons);
+        efree(bboxes);
+    }
+
+    if (err) {
+        h3_cell_list_free(&cells);
+        H3_THROW("Failed to polyfill", 0);
+        RETURN_THROWS();
+    }
+
+    if (cells.count > max_cells) {
+        h3_cell_list_free(&cells);
+        H3_THROW("Polygon does not fit in max_cells cells at any resolution", 0);
+        RETURN_THROWS();
+    }
+
+    array_init_size(return_value, cells.count);
+    h3_array_to_zend_array(cells.cells, cells.count, return_value);
+    h3_cell_list_free(&cells);
+}
+
+PHP_FUNCTION(h3_set_to_multi_polygon)
+{
+    zval *indexes;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY(indexes);
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    zend_array *indexes_arr = Z_ARR_P(indexes);
+    int num_indexes = zend_array_count(indexes_arr);
+    H3Index *set = ecalloc(num_indexes, sizeof(H3Index));
+
+    if (zend_array_to_h3_array(indexes_arr, set) != 0) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
+        efree(set);
+        RETURN_THROWS();
+    }
+
+    LinkedGeoPolygon *out = emalloc(sizeof(LinkedGeoPolygon));
+    H3Error err = cells_to_linked_multi_polygon(set, num_indexes, out);
+    if (err) {
+        efree(set);
+        efree(out);
+        H3_THROW("Failed to convert to multi polygon", 0);
+        RETURN_THROWS();
+    }
+
+    LinkedGeoPolygon *polygon = out;
+    LinkedGeoLoop *geo_loop;
+    LinkedLatLng *geo_coord;
+
+    zval polygons_val;
+    zval holes_val;
+    zval polygon_val;
+    zval geofence_val;
+    zend_object *geofence_obj;
+    zend_object *polygon_obj;
+    int geo_loop_idx;
+
+    array_init(&polygons_val);
+
+    while (polygon) {
+        array_init(&holes_val);
+
+        geo_loop = polygon->first;
+        geo_loop_idx = 0;
+        while (geo_loop) {
+            geofence_obj = geo_loop_to_geo_boundary_obj(geo_loop);
+            if (geo_loop_idx++ == 0) {
+                ZVAL_OBJ(&geofence_val, geofence_obj);
+            } else {
+                add_next_index_object(&holes_val, geofence_obj);
+            }
+            geo_loop = geo_loop->next;
+        }
+
+        polygon_obj = H3_GeoPolygon_ce->create_object(H3_GeoPolygon_ce);
+        zend_update_property(H3_GeoPolygon_ce, polygon_obj, "geofence", sizeof("geofence") - 1, &geofence_val);
+        zend_update_property(H3_GeoPolygon_ce, polygon_obj, "holes", sizeof("holes") - 1, &holes_val);
+
+        add_next_index_object(&polygons_val, polygon_obj);
+
+        zval_ptr_dtor(&holes_val);
+        zval_ptr_dtor(&geofence_val);
+
+        polygon = polygon->next;
+    }
+
+    zend_object *result = zend_objects_new(H3_GeoMultiPolygon_ce);
+    object_properties_init(result, H3_GeoMultiPolygon_ce);
+    zend_update_property(H3_GeoMultiPolygon_ce, result, "polygons", sizeof("polygons") - 1, &polygons_val);
+
+    destroyLinkedMultiPolygon(out);
+
+    zval_ptr_dtor(&polygons_val);
+
+    efree(set);
+    efree(out);
+
+    RETURN_OBJ(result);
+}
+
+PHP_FUNCTION(h3_set_to_geo_json)
+{
+    zval *indexes;
+    zval *zstream = NULL;
+    php_stream *stream = NULL;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY(indexes)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_RESOURCE_OR_NULL(zstream)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    if (zstream) {
+        php_stream_from_zval(stream, zstream);
+    }
+
+    zend_array *indexes_arr = Z_ARR_P(indexes);
+    int num_indexes = zend_array_count(indexes_arr);
+    H3Index *set = ecalloc(num_indexes, sizeof(H3Index));
+
+    if (zend_array_to_h3_array(indexes_arr, set) != 0) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
+        efree(set);
+        RETURN_THROWS();
+    }
+
+    LinkedGeoPolygon *out = emalloc(sizeof(LinkedGeoPolygon));
+    H3Error err = cells_to_linked_multi_polygon(set, num_indexes, out);
+    efree(set);
+
+    if (err) {
+        efree(out);
+        H3_THROW("Failed to convert to multi polygon", 0);
+        RETURN_THROWS();
+    }
+
+    h3_writer writer;
+    h3_writer_init(&writer, stream);
+
+    if (linked_multi_polygon_to_geo_json(&writer, out) != 0) {
+        destroyLinkedMultiPolygon(out);
+        efree(out);
+        smart_str_free(&writer.buf);
+        H3_THROW("Failed to write to stream", 0);
+        RETURN_THROWS();
+    }
+
+    destroyLinkedMultiPolygon(out);
+    efree(out);
+
+    h3_writer_finish(&writer, return_value);
+}
+
+PHP_FUNCTION(cells_to_geo_json_features)
+{
+    zend_array *indexes;
+    zend_array *properties = NULL;
+    zval *zstream = NULL;
+    php_stream *stream = NULL;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_ARRAY_HT(indexes)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY_HT_OR_NULL(properties)
+        Z_PARAM_RESOURCE_OR_NULL(zstream)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    if (zstream) {
+        php_stream_from_zval(stream, zstream);
+    }
+
+    h3_writer writer;
+    h3_writer_init(&writer, stream);
+
+    zend_ulong num_key;
+    zend_string *str_key;
+    zval *val;
+    zval *props;
+    H3Index index;
+    bool first = true;
+
+    smart_str_appends(&writer.buf, "{\"type\":\"FeatureCollection\",\"features\":[");
+
+    ZEND_HASH_FOREACH_KEY_VAL(indexes, num_key, str_key, val)
+    {
+        if (zval_to_h3(val, &index) != 0) {
+            smart_str_free(&writer.buf);
+            zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers");
+            RETURN_THROWS();
+        }
+
+        props = NULL;
+        if (properties) {
+            props = str_key ? zend_hash_find(properties, str_key) : zend_hash_index_find(properties, num_key);
+        }
+
+        if (!first) {
+            smart_str_appendc(&writer.buf, ',');
+        }
+        first = false;
+
+        if (cell_to_geo_json_feature(&writer.buf, index, props) != 0) {
+            smart_str_free(&writer.buf);
+            H3_THROW("Failed to build GeoJSON feature", 0);
+            RETURN_THROWS();
+        }
+
+        if (h3_writer_flush(&writer, H3_STREAM_CHUNK_SIZE) != 0) {
+            smart_str_free(&writer.buf);
+            H3_THROW("Failed to write to stream", 0);
+            RETURN_THROWS();
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    smart_str_appends(&writer.buf, "]}");
+
+    h3_writer_finish(&writer, return_value);
+}
+
+PHP_FUNCTION(h3_set_to_wkb)
+{
+    zval *indexes;
+    bool extended = false;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY(indexes)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(extended)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    zend_array *indexes_arr = Z_ARR_P(indexes);
+    int num_indexes = zend_array_count(indexes_arr);
+    H3Index *set = ecalloc(num_indexes, sizeof(H3Index));
+
+    if (zend_array_to_h3_array(indexes_arr, set) != 0) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
+        efree(set);
+        RETURN_THROWS();
+    }
+
+    LinkedGeoPolygon *out = emalloc(sizeof(LinkedGeoPolygon));
+    H3Error err = cells_to_linked_multi_polygon(set, num_indexes, out);
+    efree(set);
+
+    if (err) {
+        efree(out);
+        H3_THROW("Failed to convert to multi polygon", 0);
+        RETURN_THROWS();
+    }
+
+    smart_str buf = {0};
+    linked_multi_polygon_to_wkb(&buf, out, extended);
+
+    destroyLinkedMultiPolygon(out);
+    efree(out);
+
+    RETURN_STR(smart_str_extract(&buf));
+}
+
+PHP_FUNCTION(cells_to_wkb)
+{
+    zend_array *indexes;
+    bool multi = false;
+    bool extended = false;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_ARRAY_HT(indexes)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(multi)
+        Z_PARAM_BOOL(extended)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    zend_ulong num_key;
+    zend_string *str_key;
+    zval *val;
+    H3Index index;
+    CellBoundary boundary;
+    smart_str buf = {0};
+
+    if (multi) {
+        wkb_append_header(&buf, H3_WKB_MULTI_POLYGON, extended);
+        wkb_append_uint32(&buf, zend_array_count(indexes));
+    } else {
+        array_init_size(return_value, zend_array_count(indexes));
+    }
+
+    ZEND_HASH_FOREACH_KEY_VAL(indexes, num_key, str_key, val)
+    {
+        if (zval_to_h3(val, &index) != 0) {
+            smart_str_free(&buf);
+            zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers");
+            RETURN_THROWS();
+        }
+
+        if (cellToBoundary(index, &boundary)) {
+            smart_str_free(&buf);
+            H3_THROW("Failed to convert to boundary", 0);
+            RETURN_THROWS();
+        }
 
-            add_next_index_zval(return_value, &geojson_polygon_val);
+        if (multi) {
+            cell_boundary_to_wkb(&buf, &boundary, false);
+            continue;
+        }
+
+        cell_boundary_to_wkb(&buf, &boundary, extended);
+        if (str_key) {
+            add_assoc_str_ex(return_value, ZSTR_VAL(str_key), ZSTR_LEN(str_key), smart_str_extract(&buf));
         } else {
-            return -1;
+            add_index_str(return_value, num_key, smart_str_extract(&buf));
         }
     }
     ZEND_HASH_FOREACH_END();
 
-    return 0;
+    if (multi) {
+        RETURN_STR(smart_str_extract(&buf));
+    }
 }
 
-zend_object *geo_loop_to_geo_boundary_obj(LinkedGeoLoop *geo_loop)
+PHP_FUNCTION(cells_to_centers)
 {
-    LinkedLatLng *geo_coord;
-    zval coords_val;
-    zend_object *obj;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    bool packed = false;
 
-    array_init(&coords_val);
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
 
-    geo_coord = geo_loop->first;
-    while (geo_coord) {
-        add_next_index_object(&coords_val, geo_to_obj(&geo_coord->vertex));
-        geo_coord = geo_coord->next;
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
+
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
     }
 
-    obj = zend_objects_new(H3_CellBoundary_ce);
-    object_properties_init(obj, H3_CellBoundary_ce);
-    zend_update_property(H3_CellBoundary_ce, obj, "vertices", sizeof("vertices") - 1, &coords_val);
+    zend_string *coords_str = zend_string_safe_alloc(num_indexes, 2 * sizeof(double), 0, 0);
+    double *coords = (double *) ZSTR_VAL(coords_str);
+    LatLng center;
 
-    Z_TRY_DELREF(coords_val);
+    for (size_t i = 0; i < num_indexes; i++) {
+        if (cellToLatLng(indexes[i], &center)) {
+            efree(indexes);
+            zend_string_efree(coords_str);
+            H3_THROW("Failed to convert to center", 0);
+            RETURN_THROWS();
+        }
 
-    return obj;
+        coords[i * 2] = radsToDegs(center.lng);
+        coords[i * 2 + 1] = radsToDegs(center.lat);
+    }
+
+    efree(indexes);
+
+    if (packed) {
+        ZSTR_VAL(coords_str)[ZSTR_LEN(coords_str)] = '\0';
+        RETURN_NEW_STR(coords_str);
+    }
+
+    doubles_to_array(coords, num_indexes * 2, return_value);
+    zend_string_efree(coords_str);
 }
 
-PHP_FUNCTION(degs_to_rads)
+PHP_FUNCTION(cells_to_boundaries)
 {
-    double degrees;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    bool packed = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
-        Z_PARAM_DOUBLE(degrees)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    RETURN_DOUBLE(degsToRads(degrees));
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
+
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
+
+    zend_string *offsets_str = zend_string_safe_alloc(num_indexes + 1, sizeof(uint32_t), 0, 0);
+    uint32_t *offsets = (uint32_t *) ZSTR_VAL(offsets_str);
+    smart_str coords = {0};
+    CellBoundary boundary;
+    double vert[2];
+
+    smart_str_alloc(&coords, num_indexes * 6 * sizeof(vert), 0);
+    offsets[0] = 0;
+
+    for (size_t i = 0; i < num_indexes; i++) {
+        if (cellToBoundary(indexes[i], &boundary)) {
+            efree(indexes);
+            zend_string_efree(offsets_str);
+            smart_str_free(&coords);
+            H3_THROW("Failed to convert to boundary", 0);
+            RETURN_THROWS();
+        }
+
+        for (int j = 0; j < boundary.numVerts; j++) {
+            vert[0] = radsToDegs(boundary.verts[j].lng);
+            vert[1] = radsToDegs(boundary.verts[j].lat);
+            smart_str_appendl(&coords, (const char *) vert, sizeof(vert));
+        }
+
+        offsets[i + 1] = offsets[i] + boundary.numVerts;
+    }
+
+    efree(indexes);
+
+    zval coords_val;
+    zval offsets_val;
+
+    array_init_size(return_value, 2);
+
+    if (packed) {
+        ZSTR_VAL(offsets_str)[ZSTR_LEN(offsets_str)] = '\0';
+        ZVAL_STR(&coords_val, smart_str_extract(&coords));
+        ZVAL_STR(&offsets_val, offsets_str);
+    } else {
+        doubles_to_array((const double *) (coords.s ? ZSTR_VAL(coords.s) : NULL), offsets[num_indexes] * 2, &coords_val);
+        uint32s_to_array(offsets, num_indexes + 1, &offsets_val);
+        smart_str_free(&coords);
+        zend_string_efree(offsets_str);
+    }
+
+    add_assoc_zval(return_value, "coordinates", &coords_val);
+    add_assoc_zval(return_value, "offsets", &offsets_val);
 }
 
-PHP_FUNCTION(rads_to_degs)
+void h3_validate(uint64_t mode, INTERNAL_FUNCTION_PARAMETERS)
 {
-    double radians;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    bool bitmap = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
-        Z_PARAM_DOUBLE(radians)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(bitmap)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    RETURN_DOUBLE(radsToDegs(radians));
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
+
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
+
+    zend_string *bitmap_str = zend_string_alloc((num_indexes + 7) / 8, 0);
+    uint8_t *bits = (uint8_t *) ZSTR_VAL(bitmap_str);
+    size_t num_invalid = indexes_validate(indexes, num_indexes, mode, bits);
+
+    efree(indexes);
+
+    if (bitmap) {
+        ZSTR_VAL(bitmap_str)[ZSTR_LEN(bitmap_str)] = '\0';
+        RETURN_NEW_STR(bitmap_str);
+    }
+
+    array_init_size(return_value, num_invalid);
+    zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
+
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value))
+    {
+        for (size_t i = 0; num_invalid > 0 && i < num_indexes; i++) {
+            if (bits[i / 8] & (1 << (i % 8))) {
+                ZEND_HASH_FILL_SET_LONG(i);
+                ZEND_HASH_FILL_NEXT();
+            }
+        }
+    }
+    ZEND_HASH_FILL_END();
+
+    zend_string_efree(bitmap_str);
 }
 
-PHP_FUNCTION(hex_area)
+PHP_FUNCTION(validate_cells)
 {
-    zend_long res;
-    zend_long unit;
+    h3_validate(H3_CELL_MODE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(validate_directed_edges)
+{
+    h3_validate(H3_DIRECTED_EDGE_MODE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+// Parses one hex index per line into out, which needs room for a value per
+// line. Blank lines and \r before \n are skipped. Returns the number of
+// indexes, or -1 at the first line that is not plain hex.
+int64_t hex_lines_to_h3(const char *str, size_t len, H3Index *out)
+{
+    const char *end = str + len;
+    int64_t count = 0;
+
+    while (str < end) {
+        const char *eol = memchr(str, '\n', end - str);
+        size_t line_len = (eol ? eol : end) - str;
+
+        if (line_len > 0 && str[line_len - 1] == '\r') {
+            line_len--;
+        }
+
+        if (line_len > 0 && !hex_to_h3(str, line_len, &out[count++])) {
+            return -1;
+        }
+
+        str += line_len;
+        str += str < end && *str == '\r';
+        str += str < end && *str == '\n';
+    }
+
+    return count;
+}
+
+PHP_FUNCTION(cells_to_strings)
+{
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    bool joined = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(2, 2)
-        Z_PARAM_LONG(res)
-        Z_PARAM_LONG(unit)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(joined)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    VALIDATE_H3_RES(res);
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-    double out;
-    H3Error err;
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
 
-    switch (unit) {
-        case H3_AREA_UNIT_KM2:
-            err = getHexagonAreaAvgKm2(res, &out);
-            if (err) {
-                H3_THROW("Failed to get hex area", H3_ERR_CODE_INVALID_RES);
-                RETURN_THROWS();
+    if (joined) {
+        size_t len = num_indexes > 0 ? num_indexes - 1 : 0;
+
+        for (size_t i = 0; i < num_indexes; i++) {
+            len += h3_hex_len(indexes[i]);
+        }
+
+        zend_string *out = zend_string_alloc(len, 0);
+        char *p = ZSTR_VAL(out);
+
+        for (size_t i = 0; i < num_indexes; i++) {
+            int index_len = h3_hex_len(indexes[i]);
+
+            if (i > 0) {
+                *p++ = '\n';
             }
-            RETURN_DOUBLE(out);
-        case H3_AREA_UNIT_M2:
-            err = getHexagonAreaAvgM2(res, &out);
-            if (err) {
-                H3_THROW("Failed to get hex area", H3_ERR_CODE_INVALID_RES);
-                RETURN_THROWS();
+            h3_to_hex(indexes[i], p, index_len);
+            p += index_len;
+        }
+        *p = '\0';
+
+        efree(indexes);
+        RETURN_NEW_STR(out);
+    }
+
+    array_init_size(return_value, num_indexes);
+    zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
+
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value))
+    {
+        for (size_t i = 0; i < num_indexes; i++) {
+            ZEND_HASH_FILL_SET_STR(h3_to_zend_string(indexes[i]));
+            ZEND_HASH_FILL_NEXT();
+        }
+    }
+    ZEND_HASH_FILL_END();
+
+    efree(indexes);
+}
+
+PHP_FUNCTION(strings_to_cells)
+{
+    zend_array *strings_arr;
+    zend_string *strings_str;
+    bool packed = false;
+    int64_t count = 0;
+    zval *val;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT_OR_STR(strings_arr, strings_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    size_t max = strings_str ? 1 : zend_array_count(strings_arr);
+
+    if (strings_str) {
+        const char *p = ZSTR_VAL(strings_str);
+        const char *end = p + ZSTR_LEN(strings_str);
+
+        while ((p = memchr(p, '\n', end - p))) {
+            max++;
+            p++;
+        }
+    }
+
+    zend_string *indexes_str = zend_string_safe_alloc(max, sizeof(H3Index), 0, 0);
+    H3Index *indexes = (H3Index *) ZSTR_VAL(indexes_str);
+
+    if (strings_str) {
+        count = hex_lines_to_h3(ZSTR_VAL(strings_str), ZSTR_LEN(strings_str), indexes);
+    } else {
+        // Elements follow the same plain hex rule as lines
+        ZEND_HASH_FOREACH_VAL(strings_arr, val)
+        {
+            ZVAL_DEREF(val);
+            if (Z_TYPE_P(val) != IS_STRING || !hex_to_h3(Z_STRVAL_P(val), Z_STRLEN_P(val), &indexes[count++])) {
+                count = -1;
+                break;
             }
-            RETURN_DOUBLE(out);
-        default:
-            H3_THROW("Unsupported unit (must be one of H3_AREA_UNIT_KM2, or H3_AREA_UNIT_M2)",
-                     H3_ERR_CODE_UNSUPPORTED_UNIT);
-            RETURN_THROWS();
+        }
+        ZEND_HASH_FOREACH_END();
     }
+
+    if (count < 0) {
+        zend_string_efree(indexes_str);
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3 index strings, or a newline-separated string of them");
+        RETURN_THROWS();
+    }
+
+    if (packed) {
+        ZSTR_LEN(indexes_str) = count * sizeof(H3Index);
+        ZSTR_VAL(indexes_str)[ZSTR_LEN(indexes_str)] = '\0';
+        RETURN_NEW_STR(indexes_str);
+    }
+
+    indexes_to_array(indexes, count, return_value);
+    zend_string_efree(indexes_str);
 }
 
-PHP_FUNCTION(edge_length)
+PHP_FUNCTION(cells_to_parents)
 {
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
     zend_long res;
-    zend_long unit;
+    bool packed = false;
+    bool counts = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(2, 2)
+    ZEND_PARSE_PARAMETERS_START(2, 4)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
         Z_PARAM_LONG(res)
-        Z_PARAM_LONG(unit)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
+        Z_PARAM_BOOL(counts)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
     VALIDATE_H3_RES(res);
 
-    double out;
-    H3Error err;
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-    switch (unit) {
-        case H3_LENGTH_UNIT_KM:
-            err = getHexagonEdgeLengthAvgKm(res, &out);
-            if (err) {
-                H3_THROW("Failed to get edge length", H3_ERR_CODE_INVALID_RES);
-                RETURN_THROWS();
-            }
-            RETURN_DOUBLE(out);
-        case H3_LENGTH_UNIT_M:
-            err = getHexagonEdgeLengthAvgM(res, &out);
-            if (err) {
-                H3_THROW("Failed to get edge length", H3_ERR_CODE_INVALID_RES);
-                RETURN_THROWS();
-            }
-            RETURN_DOUBLE(out);
-        default:
-            H3_THROW("Unsupported unit (must be one of H3_LENGTH_UNIT_KM, or H3_LENGTH_UNIT_RADS)",
-                     H3_ERR_CODE_UNSUPPORTED_UNIT);
-            RETURN_THROWS();
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
+
+    zend_string *parents_str = zend_string_safe_alloc(num_indexes, sizeof(H3Index), 0, 0);
+    H3Index *parents = (H3Index *) ZSTR_VAL(parents_str);
+
+    if (res < H3_MIN_RES || res > H3_MAX_RES || cells_to_parents_masked(indexes, num_indexes, res, parents)) {
+        efree(indexes);
+        zend_string_efree(parents_str);
+        H3_THROW("Failed to get parent", H3_ERR_CODE_INVALID_RES);
+        RETURN_THROWS();
+    }
+
+    efree(indexes);
+
+    if (!counts) {
+        if (packed) {
+            ZSTR_VAL(parents_str)[ZSTR_LEN(parents_str)] = '\0';
+            RETURN_NEW_STR(parents_str);
+        }
+
+        indexes_to_array(parents, num_indexes, return_value);
+        zend_string_efree(parents_str);
+        return;
     }
+
+    zend_string *counts_str = zend_string_safe_alloc(num_indexes, sizeof(uint32_t), 0, 0);
+    uint32_t *parent_counts = (uint32_t *) ZSTR_VAL(counts_str);
+    size_t num_parents = cells_count_distinct(parents, num_indexes, parent_counts);
+    zval parents_val, counts_val;
+
+    if (packed) {
+        parents_str = zend_string_truncate(parents_str, num_parents * sizeof(H3Index), 0);
+        ZSTR_VAL(parents_str)[ZSTR_LEN(parents_str)] = '\0';
+        ZVAL_NEW_STR(&parents_val, parents_str);
+        counts_str = zend_string_truncate(counts_str, num_parents * sizeof(uint32_t), 0);
+        ZSTR_VAL(counts_str)[ZSTR_LEN(counts_str)] = '\0';
+        ZVAL_NEW_STR(&counts_val, counts_str);
+    } else {
+        indexes_to_array(parents, num_parents, &parents_val);
+        uint32s_to_array(parent_counts, num_parents, &counts_val);
+        zend_string_efree(parents_str);
+        zend_string_efree(counts_str);
+    }
+
+    array_init_size(return_value, 2);
+    add_assoc_zval(return_value, "parents", &parents_val);
+    add_assoc_zval(return_value, "counts", &counts_val);
 }
 
-PHP_FUNCTION(num_hexagons)
+PHP_FUNCTION(cells_to_center_children)
 {
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
     zend_long res;
+    bool packed = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
         Z_PARAM_LONG(res)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
     VALIDATE_H3_RES(res);
 
-    int64_t out;
-    H3Error err = getNumCells(res, &out);
-    if (err) {
-        H3_THROW("Failed to get number of hexagons", H3_ERR_CODE_INVALID_RES);
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
+
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
+
+    zend_string *children_str = zend_string_safe_alloc(num_indexes, sizeof(H3Index), 0, 0);
+    H3Index *children = (H3Index *) ZSTR_VAL(children_str);
+
+    if (res < H3_MIN_RES || res > H3_MAX_RES || cells_to_center_children_masked(indexes, num_indexes, res, children)) {
+        efree(indexes);
+        zend_string_efree(children_str);
+        H3_THROW("Failed to get center child", H3_ERR_CODE_INVALID_RES);
         RETURN_THROWS();
     }
 
-    RETURN_LONG(out);
+    efree(indexes);
+
+    if (packed) {
+        ZSTR_VAL(children_str)[ZSTR_LEN(children_str)] = '\0';
+        RETURN_NEW_STR(children_str);
+    }
+
+    indexes_to_array(children, num_indexes, return_value);
+    zend_string_efree(children_str);
 }
 
-PHP_FUNCTION(get_res0_indexes)
+PHP_FUNCTION(find_descendants)
 {
-    ZEND_PARSE_PARAMETERS_NONE();
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    zend_object *ancestor_obj;
+    bool bitmap = false;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OBJ_OF_CLASS(ancestor_obj, H3_H3Index_ce)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(bitmap)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
 
-    int max = res0CellCount();
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-    H3Index *indexes = ecalloc(max, sizeof(H3Index));
-    H3Error err = getRes0Cells(indexes);
-    if (err) {
-        efree(indexes);
-        H3_THROW("Failed to get res0 indexes", 0);
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
         RETURN_THROWS();
     }
 
-    array_init_size(return_value, max);
-    h3_array_to_zend_array(indexes, max, return_value);
+    zend_string *bitmap_str = zend_string_alloc((num_indexes + 7) / 8, 0);
+    uint8_t *bits = (uint8_t *) ZSTR_VAL(bitmap_str);
+    size_t num_found = cells_descend_from(indexes, num_indexes, obj_to_h3(ancestor_obj), bits);
 
     efree(indexes);
+
+    if (bitmap) {
+        ZSTR_VAL(bitmap_str)[ZSTR_LEN(bitmap_str)] = '\0';
+        RETURN_NEW_STR(bitmap_str);
+    }
+
+    array_init_size(return_value, num_found);
+    zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
+
+    ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value))
+    {
+        for (size_t i = 0; num_found > 0 && i < num_indexes; i++) {
+            if (bits[i / 8] & (1 << (i % 8))) {
+                ZEND_HASH_FILL_SET_LONG(i);
+                ZEND_HASH_FILL_NEXT();
+            }
+        }
+    }
+    ZEND_HASH_FILL_END();
+
+    zend_string_efree(bitmap_str);
 }
 
-PHP_FUNCTION(get_pentagon_indexes)
+void h3_sort(bool unique, INTERNAL_FUNCTION_PARAMETERS)
 {
-    zend_long res;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    zend_long order = H3_ORDER_INDEX;
+    bool packed = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
-        Z_PARAM_LONG(res)
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(order)
+        Z_PARAM_BOOL(packed)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    VALIDATE_H3_RES(res);
+    VALIDATE_H3_ORDER(order, 2);
+
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
+
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
 
-    int max = pentagonCount();
+    size_t num_sorted;
+    H3Error err = cells_sort(indexes, num_indexes, order, unique, &num_sorted);
 
-    H3Index *indexes = ecalloc(max, sizeof(H3Index));
-    H3Error err = getPentagons(res, indexes);
     if (err) {
         efree(indexes);
-        H3_THROW("Failed to get pentagon indexes", H3_ERR_CODE_INVALID_RES);
+        H3_THROW("Failed to sort cells", 0);
         RETURN_THROWS();
     }
 
-    array_init_size(return_value, max);
-    h3_array_to_zend_array(indexes, max, return_value);
+    if (packed) {
+        zend_string *sorted_str = zend_string_init((const char *) indexes, num_sorted * sizeof(H3Index), 0);
+        efree(indexes);
+        RETURN_NEW_STR(sorted_str);
+    }
 
+    indexes_to_array(indexes, num_sorted, return_value);
     efree(indexes);
 }
 
-PHP_FUNCTION(point_dist)
+PHP_FUNCTION(sort_cells)
+{
+    h3_sort(false, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(unique_cells)
+{
+    h3_sort(true, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(cells_to_sort_keys)
 {
-    zend_object *a;
-    zend_object *b;
-    zend_long unit;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    zend_long order = H3_ORDER_HILBERT;
+    bool packed = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(3, 3)
-        Z_PARAM_OBJ_OF_CLASS(a, H3_LatLng_ce)
-        Z_PARAM_OBJ_OF_CLASS(b, H3_LatLng_ce)
-        Z_PARAM_LONG(unit)
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(order)
+        Z_PARAM_BOOL(packed)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    LatLng *geoA = emalloc(sizeof(LatLng));
-    LatLng *geoB = emalloc(sizeof(LatLng));
+    VALIDATE_H3_ORDER(order, 2);
 
-    obj_to_geo(a, geoA);
-    obj_to_geo(b, geoB);
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-    switch (unit) {
-        case H3_LENGTH_UNIT_KM:
-            RETVAL_DOUBLE(greatCircleDistanceKm(geoA, geoB));
-            break;
-        case H3_LENGTH_UNIT_M:
-            RETVAL_DOUBLE(greatCircleDistanceM(geoA, geoB));
-            break;
-        case H3_LENGTH_UNIT_RADS:
-            RETVAL_DOUBLE(greatCircleDistanceRads(geoA, geoB));
-            break;
-        default:
-            H3_THROW("Unsupported unit (must be one of H3_LENGTH_UNIT_KM, H3_LENGTH_UNIT_M, or H3_LENGTH_UNIT_RADS)",
-                     H3_ERR_CODE_UNSUPPORTED_UNIT);
-            break;
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
     }
 
-    efree(geoA);
-    efree(geoB);
+    zend_string *keys_str = zend_string_safe_alloc(num_indexes, sizeof(uint64_t), 0, 0);
+    uint64_t *keys = (uint64_t *) ZSTR_VAL(keys_str);
 
-    if (Z_TYPE_P(return_value) == IS_NULL) {
+    if (cells_to_sort_keys(indexes, num_indexes, order, keys)) {
+        efree(indexes);
+        zend_string_efree(keys_str);
+        H3_THROW("Failed to compute sort keys", 0);
         RETURN_THROWS();
     }
+
+    efree(indexes);
+
+    if (packed) {
+        ZSTR_VAL(keys_str)[ZSTR_LEN(keys_str)] = '\0';
+        RETURN_NEW_STR(keys_str);
+    }
+
+    indexes_to_array(keys, num_indexes, return_value);
+    zend_string_efree(keys_str);
 }
 
-PHP_FUNCTION(compact)
+void h3_set_operation(int op, INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *indexes;
+    zend_array *a_arr, *b_arr;
+    zend_string *a_str, *b_str;
+    bool packed = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
-        Z_PARAM_ARRAY(indexes)
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(a_arr, a_str)
+        Z_PARAM_ARRAY_HT_OR_STR(b_arr, b_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    zend_array *arr = Z_ARR_P(indexes);
-    int count = zend_array_count(arr);
+    size_t num_a, num_b;
+    H3Index *a = h3_buffer_from_array_or_str(a_arr, a_str, &num_a);
 
-    H3Index *set = ecalloc(count, sizeof(H3Index));
-    H3Index *compactedSet = ecalloc(count, sizeof(H3Index));
+    if (!a) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
 
-    if (zend_array_to_h3_array(arr, set) != 0) {
-        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
-        efree(set);
-        efree(compactedSet);
+    H3Index *b = h3_buffer_from_array_or_str(b_arr, b_str, &num_b);
+
+    if (!b) {
+        efree(a);
+        zend_argument_error(H3_H3Exception_ce, 2, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
         RETURN_THROWS();
     }
 
-    H3Error err = compactCells(set, compactedSet, count);
-    if (err) {
-        H3_THROW("Failed to compact", H3_ERR_CODE_COMPACT_ERROR);
-        efree(set);
-        efree(compactedSet);
+    // The set kernels only look at digit bits, so other ids would be merged,
+    // split or dropped silently
+    int invalid_arg = !cells_are_valid(a, num_a) ? 1 : (!cells_are_valid(b, num_b) ? 2 : 0);
+
+    if (invalid_arg) {
+        zend_argument_error(H3_H3Exception_ce, invalid_arg, "must contain only valid cells");
+        efree(a);
+        efree(b);
         RETURN_THROWS();
     }
 
-    array_init(return_value);
-    h3_array_to_zend_array(compactedSet, count, return_value);
+    h3_cell_list out = {0};
 
-    efree(set);
-    efree(compactedSet);
+    num_a = cells_normalize(a, num_a);
+    num_b = cells_normalize(b, num_b);
+    cells_set_operation(op, a, num_a, b, num_b, &out);
+    out.count = compact_sorted_cells(out.cells, out.count);
+
+    efree(a);
+    efree(b);
+
+    if (packed) {
+        RETVAL_STRINGL(out.count ? (const char *) out.cells : "", out.count * sizeof(H3Index));
+    } else {
+        indexes_to_array(out.cells, out.count, return_value);
+    }
+
+    h3_cell_list_free(&out);
 }
 
-PHP_FUNCTION(uncompact)
+PHP_FUNCTION(cells_union)
 {
-    zval *indexes;
-    zend_long res;
+    h3_set_operation(H3_SET_UNION, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(cells_intersection)
+{
+    h3_set_operation(H3_SET_INTERSECTION, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(cells_difference)
+{
+    h3_set_operation(H3_SET_DIFFERENCE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+
+PHP_FUNCTION(cells_contain)
+{
+    zend_array *a_arr, *b_arr;
+    zend_string *a_str, *b_str;
 
     // clang-format off
     ZEND_PARSE_PARAMETERS_START(2, 2)
-        Z_PARAM_ARRAY(indexes)
-        Z_PARAM_LONG(res)
+        Z_PARAM_ARRAY_HT_OR_STR(a_arr, a_str)
+        Z_PARAM_ARRAY_HT_OR_STR(b_arr, b_str)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    VALIDATE_H3_RES(res);
-
-    zend_array *arr = Z_ARR_P(indexes);
-    int count = zend_array_count(arr);
-    H3Index *compactedSet = ecalloc(count, sizeof(H3Index));
+    size_t num_a, num_b;
+    H3Index *a = h3_buffer_from_array_or_str(a_arr, a_str, &num_a);
 
-    if (zend_array_to_h3_array(arr, compactedSet) != 0) {
-        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
-        efree(compactedSet);
+    if (!a) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
         RETURN_THROWS();
     }
 
-    int64_t max;
-    H3Error err = uncompactCellsSize(compactedSet, count, res, &max);
+    H3Index *b = h3_buffer_from_array_or_str(b_arr, b_str, &num_b);
 
-    if (err) {
-        H3_THROW("Unknown uncompact error", H3_ERR_CODE_UNCOMPACT_ERROR);
-        efree(compactedSet);
+    if (!b) {
+        efree(a);
+        zend_argument_error(H3_H3Exception_ce, 2, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
         RETURN_THROWS();
     }
 
-    H3Index *set = ecalloc(max, sizeof(H3Index));
+    int invalid_arg = !cells_are_valid(a, num_a) ? 1 : (!cells_are_valid(b, num_b) ? 2 : 0);
 
-    err = uncompactCells(compactedSet, count, set, max, res);
-    if (err) {
-        H3_THROW("Failed to uncompact", H3_ERR_CODE_UNCOMPACT_ERROR);
-        efree(compactedSet);
-        efree(set);
+    if (invalid_arg) {
+        zend_argument_error(H3_H3Exception_ce, invalid_arg, "must contain only valid cells");
+        efree(a);
+        efree(b);
         RETURN_THROWS();
     }
 
-    array_init(return_value);
-    h3_array_to_zend_array(set, max, return_value);
+    // Compacting a makes every cell of b that it covers lie inside one of its
+    // cells, even where b is coarser than the cells a was given as
+    num_a = compact_sorted_cells(a, cells_normalize(a, num_a));
+    num_b = cells_normalize(b, num_b);
+    RETVAL_BOOL(cells_set_contains(a, num_a, b, num_b));
 
-    efree(compactedSet);
-    efree(set);
+    efree(a);
+    efree(b);
 }
 
-PHP_FUNCTION(line)
+PHP_FUNCTION(connected_components)
 {
-    zend_object *start;
-    zend_object *end;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    zend_long k = 1;
+    bool grouped = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(2, 2)
-        Z_PARAM_OBJ_OF_CLASS(start, H3_H3Index_ce)
-        Z_PARAM_OBJ_OF_CLASS(end, H3_H3Index_ce)
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(k)
+        Z_PARAM_BOOL(grouped)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    h3_line(start, end, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
+    if (k < 0) {
+        zend_argument_value_error(2, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
 
-PHP_FUNCTION(distance)
-{
-    zend_object *a;
-    zend_object *b;
+    // The neighbour disks hold 3k(k+1)+1 cells each, about 3M at the cap
+    if (k > H3_MAX_DISK_K) {
+        zend_argument_value_error(2, "must be less than or equal to %d", H3_MAX_DISK_K);
+        RETURN_THROWS();
+    }
 
-    // clang-format off
-    ZEND_PARSE_PARAMETERS_START(2, 2)
-        Z_PARAM_OBJ_OF_CLASS(a, H3_H3Index_ce)
-        Z_PARAM_OBJ_OF_CLASS(b, H3_H3Index_ce)
-    ZEND_PARSE_PARAMETERS_END();
-    // clang-format on
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-    int64_t dist;
-    H3Error err = gridDistance(obj_to_h3(a), obj_to_h3(b), &dist);
-    if (err) {
-        H3_THROW("Failed to calculate distance", 0);
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
         RETURN_THROWS();
     }
 
-    RETURN_LONG(dist);
+    int threads = num_indexes >= H3_PARALLEL_MIN_CELLS ? h3_threads() : 1;
+    int64_t *components = cells_to_components(indexes, num_indexes, k, threads, true);
+
+    if (!components) {
+        efree(indexes);
+        H3_THROW("Failed to get max grid disk size", 0);
+        RETURN_THROWS();
+    }
+
+    // roots are the first cell of their component, so labels follow the
+    // order in which components first appear
+    zend_long num_components = 0;
+    for (size_t i = 0; i < num_indexes; i++) {
+        components[i] = components[i] == (int64_t) i ? num_components++ : components[components[i]];
+    }
+
+    if (grouped) {
+        zend_array **groups = safe_emalloc(num_components, sizeof(zend_array *), 0);
+        zval val;
+
+        array_init_size(return_value, num_components);
+        for (zend_long i = 0; i < num_components; i++) {
+            groups[i] = zend_new_array(0);
+            ZVAL_ARR(&val, groups[i]);
+            add_next_index_zval(return_value, &val);
+        }
+        for (size_t i = 0; i < num_indexes; i++) {
+            ZVAL_OBJ(&val, h3_to_obj(indexes[i]));
+            zend_hash_next_index_insert(groups[components[i]], &val);
+        }
+
+        efree(groups);
+    } else {
+        array_init_size(return_value, num_indexes);
+        zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
+
+        ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value))
+        {
+            for (size_t i = 0; i < num_indexes; i++) {
+                ZEND_HASH_FILL_SET_LONG(components[i]);
+                ZEND_HASH_FILL_NEXT();
+            }
+        }
+        ZEND_HASH_FILL_END();
+    }
+
+    efree(components);
+    efree(indexes);
 }
 
-PHP_FUNCTION(indexes_are_neighbors)
+H3Error cell_list_to_array(const h3_cell_list *list, int res, bool compact, zval *out)
 {
-    zend_object *org;
-    zend_object *dest;
+    h3_cell_list compacted = {0};
+    H3Index *cells;
+    int64_t size;
+    H3Error err;
 
-    // clang-format off
-    ZEND_PARSE_PARAMETERS_START(2, 2)
-        Z_PARAM_OBJ_OF_CLASS(org, H3_H3Index_ce)
-        Z_PARAM_OBJ_OF_CLASS(dest, H3_H3Index_ce)
-    ZEND_PARSE_PARAMETERS_END();
-    // clang-format on
+    if (compact) {
+        err = compact_mixed_cells(list->cells, list->count, &compacted);
+        if (!err) {
+            array_init_size(out, compacted.count);
+            h3_array_to_zend_array(compacted.cells, compacted.count, out);
+        }
+        h3_cell_list_free(&compacted);
 
-    H3Index origin = obj_to_h3(org);
-    H3Index destination = obj_to_h3(dest);
+        return err;
+    }
 
-    int out;
-    H3Error err = areNeighborCells(origin, destination, &out);
+    err = uncompactCellsSize(list->cells, list->count, res, &size);
     if (err) {
-        H3_THROW("Failed to check neighbors", 0);
-        RETURN_THROWS();
+        return err;
     }
 
-    RETURN_BOOL(out);
+    cells = ecalloc(size, sizeof(H3Index));
+    err = uncompactCells(list->cells, list->count, cells, size, res);
+    if (!err) {
+        array_init_size(out, size);
+        h3_array_to_zend_array(cells, size, out);
+    }
+    efree(cells);
+
+    return err;
 }
 
-PHP_FUNCTION(polyfill)
+void h3_morphology(bool dilate, INTERNAL_FUNCTION_PARAMETERS)
 {
-    zend_object *polygon;
-    zend_long res;
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    zend_long k;
+    bool compact = false;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(2, 2)
-        Z_PARAM_OBJ_OF_CLASS(polygon, H3_GeoPolygon_ce)
-        Z_PARAM_LONG(res)
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_LONG(k)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(compact)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    VALIDATE_H3_RES(res);
-
-    zval *geofence_val;
-    zval rv;
-    zend_object *geofence_obj;
-    zval *geofence_verts_val;
-    zend_array *geofence_verts_arr;
-    zval *holes_val;
-    zend_array *holes_arr;
-
-    geofence_val = zend_read_property(H3_GeoPolygon_ce, polygon, "geofence", sizeof("geofence") - 1, 1, &rv);
-    geofence_obj = Z_OBJ_P(geofence_val);
+    if (k < 0) {
+        zend_argument_value_error(2, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
 
-    geofence_verts_val = zend_read_property(H3_CellBoundary_ce, geofence_obj, "vertices", sizeof("vertices") - 1, 1, &rv);
-    geofence_verts_arr = Z_ARR_P(geofence_verts_val);
+    // Erosion sizes its disks from k, and dilation grows by k rings
+    if (k > H3_MAX_DISK_K) {
+        zend_argument_value_error(2, "must be less than or equal to %d", H3_MAX_DISK_K);
+        RETURN_THROWS();
+    }
 
-    uint32_t geofence_num_verts = zend_array_count(geofence_verts_arr);
-    LatLng *geofence_verts = ecalloc(geofence_num_verts, sizeof(LatLng));
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-    if (zend_array_to_geocoord_array(geofence_verts_arr, geofence_verts) != 0) {
-        zend_argument_error(H3_H3Exception_ce, 1, "must be valid GeoPolygon object");
-        efree(geofence_verts);
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
         RETURN_THROWS();
     }
 
-    holes_val = zend_read_property(H3_GeoPolygon_ce, polygon, "holes", sizeof("holes") - 1, 1, &rv);
-    holes_arr = Z_ARR_P(holes_val);
+    h3_cell_set set;
+    h3_cell_list cells = {0};
+    int res;
+    H3Error err = cells_to_compact_set(indexes, num_indexes, &set, &res);
 
-    uint32_t num_holes = zend_array_count(holes_arr);
-    GeoLoop *holes = ecalloc(num_holes, sizeof(GeoLoop));
+    efree(indexes);
 
-    if (zend_array_to_geoloop_array(holes_arr, holes) != 0) {
-        zend_argument_error(H3_H3Exception_ce, 1, "must be valid GeoPolygon object");
-        efree(geofence_verts);
-        efree(holes);
+    if (err == E_CELL_INVALID) {
+        H3_THROW("Invalid H3 index", H3_ERR_CODE_INVALID_INDEX);
         RETURN_THROWS();
     }
 
-    GeoPolygon geo_polygon = {
-        .geoloop = {
-            .numVerts = geofence_num_verts,
-            .verts = geofence_verts,
-        },
-        .numHoles = num_holes,
-        .holes = holes,
-    };
-
-    int64_t max;
-    H3Error err = maxPolygonToCellsSize(&geo_polygon, res, 0, &max);
-    if (err) {
-        efree(geofence_verts);
-        efree(holes);
-        H3_THROW("Failed to calculate polyfill size", 0);
+    // Rings wider than the whole grid at res add nothing the input can use,
+    // and would only size the disks and sets from k
+    int64_t disk_size;
+    if (!err && set.count > 0 && (maxGridDiskSize(k, &disk_size) != E_SUCCESS || disk_size > h3_res_tables[res].num_cells)) {
+        h3_cell_set_free(&set);
+        zend_argument_error(H3_H3Exception_ce, 2, "must not exceed the size of the grid at the resolution of the cells");
         RETURN_THROWS();
     }
 
-    H3Index *out = ecalloc(max, sizeof(H3Index));
-    err = polygonToCells(&geo_polygon, res, 0, out);
+    if (!err) {
+        if (dilate) {
+            err = cell_set_dilate(&set, k, res, &cells);
+        } else {
+            h3_cell_list exposed = {0};
+            err = cell_set_refine(&set, k, res, &cells, &exposed);
+            h3_cell_list_free(&exposed);
+        }
+        h3_cell_set_free(&set);
+    }
+
+    if (!err) {
+        err = cell_list_to_array(&cells, res, compact, return_value);
+    }
+
+    h3_cell_list_free(&cells);
+
     if (err) {
-        efree(geofence_verts);
-        efree(holes);
-        efree(out);
-        H3_THROW("Failed to polyfill", 0);
+        H3_THROW(dilate ? "Failed to dilate" : "Failed to erode", 0);
         RETURN_THROWS();
     }
+}
 
-    array_init(return_value);
-    h3_array_to_zend_array(out, max, return_value);
+PHP_FUNCTION(dilate)
+{
+    h3_morphology(true, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
 
-    efree(geofence_verts);
-    efree(holes);
-    efree(out);
+PHP_FUNCTION(erode)
+{
+    h3_morphology(false, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 
-PHP_FUNCTION(h3_set_to_multi_polygon)
+PHP_FUNCTION(smooth)
 {
-    zval *indexes;
+    zend_array *values_arr;
+    zend_long k;
+    zend_array *weights_arr = NULL;
+    bool normalize = true;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
-        Z_PARAM_ARRAY(indexes);
+    ZEND_PARSE_PARAMETERS_START(2, 4)
+        Z_PARAM_ARRAY_HT(values_arr)
+        Z_PARAM_LONG(k)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY_HT_OR_NULL(weights_arr)
+        Z_PARAM_BOOL(normalize)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
-    zend_array *indexes_arr = Z_ARR_P(indexes);
-    int num_indexes = zend_array_count(indexes_arr);
-    H3Index *set = ecalloc(num_indexes, sizeof(H3Index));
+    if (k < 0) {
+        zend_argument_value_error(2, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
 
-    if (zend_array_to_h3_array(indexes_arr, set) != 0) {
-        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects");
-        efree(set);
+    // The neighbour disks hold 3k(k+1)+1 cells each, about 3M at the cap
+    if (k > H3_MAX_DISK_K) {
+        zend_argument_value_error(2, "must be less than or equal to %d", H3_MAX_DISK_K);
+        RETURN_THROWS();
+    }
+
+    if (weights_arr && zend_array_count(weights_arr) != k + 1) {
+        zend_argument_value_error(3, "must contain one weight per ring from 0 to k");
+        RETURN_THROWS();
+    }
+
+    int64_t count = zend_array_count(values_arr);
+    H3Index *cells = safe_emalloc(count, sizeof(H3Index), 0);
+    double *values = safe_emalloc(count, 3 * sizeof(double), 0);
+    double *sums = values + count;
+    double *norms = sums + count;
+    zend_ulong num_key;
+    zend_string *str_key;
+    zval *val;
+    int64_t idx = 0;
+    int res = 0;
+
+    ZEND_HASH_FOREACH_KEY_VAL(values_arr, num_key, str_key, val)
+    {
+        if (!str_key) {
+            cells[idx] = num_key;
+        } else if (zend_string_to_h3(str_key, &cells[idx]) != E_SUCCESS) {
+            efree(cells);
+            efree(values);
+            zend_argument_error(H3_H3Exception_ce, 1, "must be keyed by H3 indexes as integers or strings");
+            RETURN_THROWS();
+        }
+
+        res = MAX(res, H3_GET_RES(cells[idx]));
+
+        if (zval_to_double(val, &values[idx++]) != 0) {
+            efree(cells);
+            efree(values);
+            zend_argument_error(H3_H3Exception_ce, 1, "must be an array of numbers");
+            RETURN_THROWS();
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    // Integer keys are taken as they are and string keys are only parsed, so
+    // check both kinds the same way
+    if (!cells_are_valid(cells, count)) {
+        efree(cells);
+        efree(values);
+        zend_argument_error(H3_H3Exception_ce, 1, "must be keyed by H3 indexes as integers or strings");
+        RETURN_THROWS();
+    }
+
+    // The neighbour disks are sized from k, so reject rings wider than the
+    // whole grid at the finest resolution of the input before allocating them
+    int64_t disk_size;
+    if (count > 0 && (maxGridDiskSize(k, &disk_size) != E_SUCCESS || disk_size > h3_res_tables[res].num_cells)) {
+        efree(cells);
+        efree(values);
+        zend_argument_error(H3_H3Exception_ce, 2, "must not exceed the size of the grid at the resolution of the cells");
+        RETURN_THROWS();
+    }
+
+    double *weights = safe_emalloc(k + 1, sizeof(double), 0);
+    zend_long ring = 0;
+
+    if (weights_arr) {
+        ZEND_HASH_FOREACH_VAL(weights_arr, val)
+        {
+            if (zval_to_double(val, &weights[ring++]) != 0) {
+                efree(weights);
+                efree(cells);
+                efree(values);
+                zend_argument_error(H3_H3Exception_ce, 3, "must be an array of numbers");
+                RETURN_THROWS();
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    } else {
+        for (zend_long i = 0; i <= k; i++) {
+            weights[i] = 1.0;
+        }
+    }
+
+    int threads = count >= H3_PARALLEL_MIN_CELLS ? h3_threads() : 1;
+    H3Error err = cells_convolve(cells, values, count, k, weights, threads, sums, norms);
+
+    efree(weights);
+    efree(cells);
+
+    if (err == E_DUPLICATE_INPUT) {
+        efree(values);
+        zend_argument_error(H3_H3Exception_ce, 1, "must not contain the same cell twice");
         RETURN_THROWS();
     }
 
-    LinkedGeoPolygon *out = emalloc(sizeof(LinkedGeoPolygon));
-    H3Error err = cellsToLinkedMultiPolygon(set, num_indexes, out);
     if (err) {
-        efree(set);
-        efree(out);
-        H3_THROW("Failed to convert to multi polygon", 0);
+        efree(values);
+        H3_THROW("Failed to get max grid disk size", 0);
         RETURN_THROWS();
     }
 
-    LinkedGeoPolygon *polygon = out;
-    LinkedGeoLoop *geo_loop;
-    LinkedLatLng *geo_coord;
+    array_init_size(return_value, count);
+    idx = 0;
 
-    zval polygons_val;
-    zval holes_val;
-    zval polygon_val;
-    zval geofence_val;
-    zend_object *geofence_obj;
-    zend_object *polygon_obj;
-    int geo_loop_idx;
+    ZEND_HASH_FOREACH_KEY(values_arr, num_key, str_key)
+    {
+        double smoothed = sums[idx];
+        if (normalize) {
+            smoothed = norms[idx] != 0 ? sums[idx] / norms[idx] : 0;
+        }
+        idx++;
 
-    array_init(&polygons_val);
+        if (str_key) {
+            add_assoc_double_ex(return_value, ZSTR_VAL(str_key), ZSTR_LEN(str_key), smoothed);
+        } else {
+            add_index_double(return_value, num_key, smoothed);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
 
-    while (polygon) {
-        array_init(&holes_val);
+    efree(values);
+}
 
-        geo_loop = polygon->first;
-        geo_loop_idx = 0;
-        while (geo_loop) {
-            geofence_obj = geo_loop_to_geo_boundary_obj(geo_loop);
-            if (geo_loop_idx++ == 0) {
-                ZVAL_OBJ(&geofence_val, geofence_obj);
-            } else {
-                add_next_index_object(&holes_val, geofence_obj);
-            }
-            geo_loop = geo_loop->next;
-        }
+PHP_FUNCTION(decode_cells)
+{
+    zend_array *indexes_arr;
+    zend_string *indexes_str;
+    bool packed = false;
 
-        polygon_obj = zend_objects_new(H3_GeoPolygon_ce);
-        object_properties_init(polygon_obj, H3_GeoPolygon_ce);
-        zend_update_property(H3_GeoPolygon_ce, polygon_obj, "geofence", sizeof("geofence") - 1, &geofence_val);
-        zend_update_property(H3_GeoPolygon_ce, polygon_obj, "holes", sizeof("holes") - 1, &holes_val);
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT_OR_STR(indexes_arr, indexes_str)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(packed)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
 
-        add_next_index_object(&polygons_val, polygon_obj);
+    size_t num_indexes;
+    H3Index *indexes = h3_buffer_from_array_or_str(indexes_arr, indexes_str, &num_indexes);
 
-        zval_ptr_dtor(&holes_val);
-        zval_ptr_dtor(&geofence_val);
+    if (!indexes) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be an array of H3Index objects or integers, or a packed string of 64-bit indexes");
+        RETURN_THROWS();
+    }
 
-        polygon = polygon->next;
+    const char *names[] = {"resolution", "base_cell", "is_pentagon", "is_class_iii"};
+    zend_string *flags[4];
+    zend_string *faces_str = zend_string_safe_alloc(num_indexes, sizeof(uint32_t), 0, 0);
+    uint32_t *faces = (uint32_t *) ZSTR_VAL(faces_str);
+
+    for (int i = 0; i < 4; i++) {
+        flags[i] = zend_string_alloc(num_indexes, 0);
+        ZSTR_VAL(flags[i])[num_indexes] = '\0';
     }
 
-    zend_object *result = zend_objects_new(H3_GeoMultiPolygon_ce);
-    object_properties_init(result, H3_GeoMultiPolygon_ce);
-    zend_update_property(H3_GeoMultiPolygon_ce, result, "polygons", sizeof("polygons") - 1, &polygons_val);
+    cells_decode(indexes, num_indexes, (uint8_t *) ZSTR_VAL(flags[0]), (uint8_t *) ZSTR_VAL(flags[1]),
+        (uint8_t *) ZSTR_VAL(flags[2]), (uint8_t *) ZSTR_VAL(flags[3]));
 
-    destroyLinkedMultiPolygon(out);
+    for (size_t i = 0; i < num_indexes; i++) {
+        if (cell_to_faces_mask(indexes[i], &faces[i]) != E_SUCCESS) {
+            efree(indexes);
+            zend_string_efree(faces_str);
+            for (int j = 0; j < 4; j++) {
+                zend_string_efree(flags[j]);
+            }
+            H3_THROW("Failed to get icosahedron faces", H3_ERR_CODE_INVALID_INDEX);
+            RETURN_THROWS();
+        }
+    }
 
-    zval_ptr_dtor(&polygons_val);
+    efree(indexes);
 
-    efree(set);
-    efree(out);
+    zval val;
+    array_init_size(return_value, 5);
 
-    RETURN_OBJ(result);
+    for (int i = 0; i < 4; i++) {
+        if (packed) {
+            ZVAL_STR(&val, flags[i]);
+        } else {
+            uint8s_to_array((const uint8_t *) ZSTR_VAL(flags[i]), num_indexes, &val);
+            zend_string_efree(flags[i]);
+        }
+        add_assoc_zval(return_value, names[i], &val);
+    }
+
+    if (packed) {
+        ZSTR_VAL(faces_str)[ZSTR_LEN(faces_str)] = '\0';
+        ZVAL_STR(&val, faces_str);
+    } else {
+        uint32s_to_array(faces, num_indexes, &val);
+        zend_string_efree(faces_str);
+    }
+    add_assoc_zval(return_value, "faces", &val);
 }
 
 PHP_FUNCTION(experimental_h3_to_local_ij)
@@ -1064,7 +6105,7 @@ PHP_METHOD(H3_H3Index, fromString)
     // clang-format on
 
     H3Index index;
-    H3Error err = stringToH3(ZSTR_VAL(value), &index);
+    H3Error err = zend_string_to_h3(value, &index);
     if (err) {
         H3_THROW("Failed to parse H3 index string", H3_ERR_CODE_INVALID_INDEX);
         RETURN_THROWS();
@@ -1089,12 +6130,11 @@ PHP_METHOD(H3_H3Index, fromGeo)
 
     VALIDATE_H3_RES(res);
 
-    LatLng *geo = emalloc(sizeof(LatLng));
-    obj_to_geo(geo_obj, geo);
+    LatLng geo;
+    obj_to_geo(geo_obj, &geo);
 
     H3Index index;
-    H3Error err = latLngToCell(geo, res, &index);
-    efree(geo);
+    H3Error err = latLngToCell(&geo, res, &index);
 
     if (err) {
         H3_THROW("Failed to create H3 index from geo coordinates", 0);
@@ -1152,10 +6192,11 @@ PHP_METHOD(H3_H3Index, getFaces)
         RETURN_THROWS();
     }
 
-    int *out = ecalloc(max, sizeof(int));
+    h3_scratch_mark mark = h3_scratch_save();
+    int *out = h3_scratch_calloc(max, sizeof(int));
     err = getIcosahedronFaces(index, out);
     if (err) {
-        efree(out);
+        h3_scratch_restore(mark);
         H3_THROW("Failed to get faces", 0);
         RETURN_THROWS();
     }
@@ -1168,19 +6209,24 @@ PHP_METHOD(H3_H3Index, getFaces)
         }
     }
 
-    efree(out);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, kRing)
 {
     zend_long k;
+    zend_long output = H3_OUTPUT_LIST;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
         Z_PARAM_LONG(k)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(output)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
+    VALIDATE_H3_OUTPUT(output, 2);
+
     int64_t max;
     H3Error err = maxGridDiskSize(k, &max);
     if (err) {
@@ -1189,30 +6235,39 @@ PHP_METHOD(H3_H3Index, kRing)
     }
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-    H3Index *out = ecalloc(max, sizeof(H3Index));
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *out = h3_scratch_calloc(max, sizeof(H3Index));
     err = gridDisk(index, k, out);
     if (err) {
-        efree(out);
+        h3_scratch_restore(mark);
         H3_THROW("Failed to get grid disk", 0);
         RETURN_THROWS();
     }
 
     array_init(return_value);
-    h3_array_to_zend_array(out, max, return_value);
+    h3_array_add_to_zval(out, max, output, return_value);
 
-    efree(out);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, kRingDistances)
 {
     zend_long k;
+    zend_long format = H3_DISTANCES_NESTED;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
         Z_PARAM_LONG(k)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(format)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
+    if (format != H3_DISTANCES_NESTED && format != H3_DISTANCES_MAP && format != H3_DISTANCES_PACKED) {
+        zend_argument_value_error(2, "must be one of H3_DISTANCES_NESTED, H3_DISTANCES_MAP, or H3_DISTANCES_PACKED");
+        RETURN_THROWS();
+    }
+
     int64_t max;
     H3Error err = maxGridDiskSize(k, &max);
     if (err) {
@@ -1221,34 +6276,19 @@ PHP_METHOD(H3_H3Index, kRingDistances)
     }
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-    H3Index *out = ecalloc(max, sizeof(H3Index));
-    int *distances = ecalloc(max, sizeof(int));
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *out = h3_scratch_calloc(max, sizeof(H3Index));
+    int *distances = h3_scratch_calloc(max, sizeof(int));
     err = gridDiskDistances(index, k, out, distances);
     if (err) {
-        efree(out);
-        efree(distances);
+        h3_scratch_restore(mark);
         H3_THROW("Failed to get grid disk distances", 0);
         RETURN_THROWS();
     }
 
-    array_init_size(return_value, k + 1);
-
-    zval *values = ecalloc(k + 1, sizeof(zval));
-
-    for (int i = 0; i < (k + 1); i++) {
-        array_init(&values[i]);
-        add_next_index_zval(return_value, &values[i]);
-    }
-
-    for (int64_t i = 0; i < max; i++) {
-        if (out[i] != H3_INVALID_INDEX) {
-            add_next_index_object(&values[distances[i]], h3_to_obj(out[i]));
-        }
-    }
+    grid_distances_to_zval(out, distances, max, k, format, return_value);
 
-    efree(out);
-    efree(distances);
-    efree(values);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, hexRange)
@@ -1269,19 +6309,20 @@ PHP_METHOD(H3_H3Index, hexRange)
     }
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-    H3Index *out = ecalloc(max, sizeof(H3Index));
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *out = h3_scratch_calloc(max, sizeof(H3Index));
 
     err = gridDiskUnsafe(index, k, out);
     if (err) {
         H3_THROW("Pentagonal distortion is encountered", H3_ERR_CODE_PENTAGON_ENCOUNTERED);
-        efree(out);
+        h3_scratch_restore(mark);
         RETURN_THROWS();
     }
 
     array_init(return_value);
     h3_array_to_zend_array(out, max, return_value);
 
-    efree(out);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, hexRing)
@@ -1297,31 +6338,40 @@ PHP_METHOD(H3_H3Index, hexRing)
     int max = max_hex_kring_size(k);
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-    H3Index *out = ecalloc(max, sizeof(H3Index));
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *out = h3_scratch_calloc(max, sizeof(H3Index));
 
     H3Error err = gridRingUnsafe(index, k, out);
     if (err) {
         H3_THROW("Pentagonal distortion is encountered", H3_ERR_CODE_PENTAGON_ENCOUNTERED);
-        efree(out);
+        h3_scratch_restore(mark);
         RETURN_THROWS();
     }
 
     array_init(return_value);
     h3_array_to_zend_array(out, max, return_value);
 
-    efree(out);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, hexRangeDistances)
 {
     zend_long k;
+    zend_long format = H3_DISTANCES_NESTED;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
         Z_PARAM_LONG(k)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(format)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
+    if (format != H3_DISTANCES_NESTED && format != H3_DISTANCES_MAP && format != H3_DISTANCES_PACKED) {
+        zend_argument_value_error(2, "must be one of H3_DISTANCES_NESTED, H3_DISTANCES_MAP, or H3_DISTANCES_PACKED");
+        RETURN_THROWS();
+    }
+
     int64_t max;
     H3Error err = maxGridDiskSize(k, &max);
     if (err) {
@@ -1330,35 +6380,20 @@ PHP_METHOD(H3_H3Index, hexRangeDistances)
     }
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-    H3Index *out = ecalloc(max, sizeof(H3Index));
-    int *distances = ecalloc(max, sizeof(int));
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *out = h3_scratch_calloc(max, sizeof(H3Index));
+    int *distances = h3_scratch_calloc(max, sizeof(int));
 
     err = gridDiskDistancesUnsafe(index, k, out, distances);
     if (err) {
         H3_THROW("Pentagonal distortion is encountered", H3_ERR_CODE_PENTAGON_ENCOUNTERED);
-        efree(out);
-        efree(distances);
+        h3_scratch_restore(mark);
         RETURN_THROWS();
     }
 
-    array_init_size(return_value, k + 1);
-
-    zval *values = ecalloc(k + 1, sizeof(zval));
-
-    for (int i = 0; i < (k + 1); i++) {
-        array_init(&values[i]);
-        add_next_index_zval(return_value, &values[i]);
-    }
-
-    for (int64_t i = 0; i < max; i++) {
-        if (out[i] != H3_INVALID_INDEX) {
-            add_next_index_object(&values[distances[i]], h3_to_obj(out[i]));
-        }
-    }
+    grid_distances_to_zval(out, distances, max, k, format, return_value);
 
-    efree(out);
-    efree(distances);
-    efree(values);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, getCellArea)
@@ -1427,6 +6462,19 @@ PHP_METHOD(H3_H3Index, isNeighborTo)
     RETURN_BOOL(out);
 }
 
+PHP_METHOD(H3_H3Index, isIn)
+{
+    zend_array *set;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY_HT(set)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    RETURN_BOOL(zend_hash_index_exists(set, obj_to_h3(Z_OBJ_P(ZEND_THIS))));
+}
+
 PHP_METHOD(H3_H3Index, getLineTo)
 {
     zend_object *dest;
@@ -1465,18 +6513,15 @@ PHP_METHOD(H3_H3Index, getDirectedEdges)
     ZEND_PARSE_PARAMETERS_NONE();
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-    H3DirectedEdge *edges = ecalloc(H3_HEX_NUM_EDGES, sizeof(H3DirectedEdge));
+    H3DirectedEdge edges[H3_HEX_NUM_EDGES] = {0};
     H3Error err = originToDirectedEdges(index, edges);
     if (err) {
-        efree(edges);
         H3_THROW("Failed to get directed edges", 0);
         RETURN_THROWS();
     }
 
     array_init_size(return_value, H3_HEX_NUM_EDGES);
     h3de_array_to_zend_array(edges, H3_HEX_NUM_EDGES, return_value);
-
-    efree(edges);
 }
 
 PHP_METHOD(H3_H3Index, getDirectedEdge)
@@ -1529,14 +6574,18 @@ PHP_METHOD(H3_H3Index, toParent)
 PHP_METHOD(H3_H3Index, toChildren)
 {
     zend_long res;
+    zend_long output = H3_OUTPUT_LIST;
 
     // clang-format off
-    ZEND_PARSE_PARAMETERS_START(1, 1)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
         Z_PARAM_LONG(res)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(output)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
     VALIDATE_H3_RES(res);
+    VALIDATE_H3_OUTPUT(output, 2);
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
 
@@ -1547,18 +6596,19 @@ PHP_METHOD(H3_H3Index, toChildren)
         RETURN_THROWS();
     }
 
-    H3Index *children = ecalloc(max, sizeof(H3Index));
+    h3_scratch_mark mark = h3_scratch_save();
+    H3Index *children = h3_scratch_calloc(max, sizeof(H3Index));
     err = cellToChildren(index, res, children);
     if (err) {
-        efree(children);
+        h3_scratch_restore(mark);
         H3_THROW("Failed to get children", H3_ERR_CODE_INVALID_RES);
         RETURN_THROWS();
     }
 
     array_init(return_value);
-    h3_array_to_zend_array(children, max, return_value);
+    h3_array_add_to_zval(children, max, output, return_value);
 
-    efree(children);
+    h3_scratch_restore(mark);
 }
 
 PHP_METHOD(H3_H3Index, toCenterChild)
@@ -1595,17 +6645,7 @@ PHP_METHOD(H3_H3Index, toString)
 {
     ZEND_PARSE_PARAMETERS_NONE();
 
-    H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
-
-    char *out = emalloc(H3_STRVAL_LEN);
-    H3Error err = h3ToString(index, out, H3_STRVAL_LEN);
-    if (err) {
-        efree(out);
-        H3_THROW("Failed to convert H3 index to string", 0);
-        RETURN_THROWS();
-    }
-    RETVAL_STRINGL(out, strlen(out));
-    efree(out);
+    RETURN_NEW_STR(h3_to_zend_string(obj_to_h3(Z_OBJ_P(ZEND_THIS))));
 }
 
 PHP_METHOD(H3_H3Index, toGeo)
@@ -1614,15 +6654,13 @@ PHP_METHOD(H3_H3Index, toGeo)
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
 
-    LatLng *geo = emalloc(sizeof(LatLng));
-    H3Error err = cellToLatLng(index, geo);
+    LatLng geo;
+    H3Error err = cellToLatLng(index, &geo);
     if (err) {
-        efree(geo);
         H3_THROW("Failed to convert to geo", 0);
         RETURN_THROWS();
     }
-    RETVAL_OBJ(geo_to_obj(geo));
-    efree(geo);
+    RETURN_OBJ(geo_to_obj(&geo));
 }
 
 PHP_METHOD(H3_H3Index, toGeoBoundary)
@@ -1631,32 +6669,46 @@ PHP_METHOD(H3_H3Index, toGeoBoundary)
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
 
-    CellBoundary *boundary = emalloc(sizeof(CellBoundary));
-    H3Error err = cellToBoundary(index, boundary);
+    CellBoundary boundary;
+    H3Error err = cellToBoundary(index, &boundary);
     if (err) {
-        efree(boundary);
         H3_THROW("Failed to convert to boundary", 0);
         RETURN_THROWS();
     }
-    RETVAL_OBJ(geo_boundary_to_obj(boundary));
-    efree(boundary);
+    RETURN_OBJ(geo_boundary_to_obj(&boundary));
 }
 
-PHP_METHOD(H3_H3Index, __toString)
+PHP_METHOD(H3_H3Index, toWkb)
 {
-    ZEND_PARSE_PARAMETERS_NONE();
+    bool extended = false;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(extended)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
 
     H3Index index = obj_to_h3(Z_OBJ_P(ZEND_THIS));
 
-    char *out = emalloc(H3_STRVAL_LEN);
-    H3Error err = h3ToString(index, out, H3_STRVAL_LEN);
+    CellBoundary boundary;
+    H3Error err = cellToBoundary(index, &boundary);
     if (err) {
-        efree(out);
-        H3_THROW("Failed to convert H3 index to string", 0);
+        H3_THROW("Failed to convert to boundary", 0);
         RETURN_THROWS();
     }
-    RETVAL_STRINGL(out, strlen(out));
-    efree(out);
+
+    smart_str buf = {0};
+    cell_boundary_to_wkb(&buf, &boundary, extended);
+
+    RETURN_STR(smart_str_extract(&buf));
+}
+
+PHP_METHOD(H3_H3Index, __toString)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_NEW_STR(h3_to_zend_string(obj_to_h3(Z_OBJ_P(ZEND_THIS))));
 }
 
 PHP_METHOD(H3_H3DirectedEdge, __construct)
@@ -1704,7 +6756,7 @@ PHP_METHOD(H3_H3DirectedEdge, fromString)
     // clang-format on
 
     H3DirectedEdge edge;
-    H3Error err = stringToH3(ZSTR_VAL(value), &edge);
+    H3Error err = zend_string_to_h3(value, &edge);
     if (err) {
         H3_THROW("Failed to parse H3 edge string", H3_ERR_CODE_INVALID_INDEX);
         RETURN_THROWS();
@@ -1759,18 +6811,15 @@ PHP_METHOD(H3_H3DirectedEdge, getIndexes)
     ZEND_PARSE_PARAMETERS_NONE();
 
     H3DirectedEdge edge = obj_to_h3de(Z_OBJ_P(ZEND_THIS));
-    H3Index *out = ecalloc(H3_EDGE_NUM_INDX, sizeof(H3Index));
+    H3Index out[H3_EDGE_NUM_INDX] = {0};
     H3Error err = directedEdgeToCells(edge, out);
     if (err) {
-        efree(out);
         H3_THROW("Failed to get edge cells", 0);
         RETURN_THROWS();
     }
 
     array_init_size(return_value, H3_EDGE_NUM_INDX);
     h3_array_to_zend_array(out, H3_EDGE_NUM_INDX, return_value);
-
-    efree(out);
 }
 
 PHP_METHOD(H3_H3DirectedEdge, getBoundary)
@@ -1778,17 +6827,14 @@ PHP_METHOD(H3_H3DirectedEdge, getBoundary)
     ZEND_PARSE_PARAMETERS_NONE();
 
     H3DirectedEdge edge = obj_to_h3de(Z_OBJ_P(ZEND_THIS));
-    CellBoundary *boundary = emalloc(sizeof(CellBoundary));
-    H3Error err = directedEdgeToBoundary(edge, boundary);
+    CellBoundary boundary;
+    H3Error err = directedEdgeToBoundary(edge, &boundary);
     if (err) {
-        efree(boundary);
         H3_THROW("Failed to get edge boundary", 0);
         RETURN_THROWS();
     }
 
-    RETVAL_OBJ(geo_boundary_to_obj(boundary));
-
-    efree(boundary);
+    RETURN_OBJ(geo_boundary_to_obj(&boundary));
 }
 
 PHP_METHOD(H3_H3DirectedEdge, getLength)
@@ -1845,34 +6891,14 @@ PHP_METHOD(H3_H3DirectedEdge, toString)
 {
     ZEND_PARSE_PARAMETERS_NONE();
 
-    H3DirectedEdge edge = obj_to_h3de(Z_OBJ_P(ZEND_THIS));
-
-    char *out = emalloc(H3_STRVAL_LEN);
-    H3Error err = h3ToString(edge, out, H3_STRVAL_LEN);
-    if (err) {
-        efree(out);
-        H3_THROW("Failed to convert edge to string", 0);
-        RETURN_THROWS();
-    }
-    RETVAL_STRINGL(out, strlen(out));
-    efree(out);
+    RETURN_NEW_STR(h3_to_zend_string(obj_to_h3de(Z_OBJ_P(ZEND_THIS))));
 }
 
 PHP_METHOD(H3_H3DirectedEdge, __toString)
 {
     ZEND_PARSE_PARAMETERS_NONE();
 
-    H3DirectedEdge edge = obj_to_h3de(Z_OBJ_P(ZEND_THIS));
-
-    char *out = emalloc(H3_STRVAL_LEN);
-    H3Error err = h3ToString(edge, out, H3_STRVAL_LEN);
-    if (err) {
-        efree(out);
-        H3_THROW("Failed to convert edge to string", 0);
-        RETURN_THROWS();
-    }
-    RETVAL_STRINGL(out, strlen(out));
-    efree(out);
+    RETURN_NEW_STR(h3_to_zend_string(obj_to_h3de(Z_OBJ_P(ZEND_THIS))));
 }
 
 PHP_METHOD(H3_LatLng, __construct)
@@ -1886,6 +6912,8 @@ PHP_METHOD(H3_LatLng, __construct)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
+    h3_geometry_construct(Z_OBJ_P(ZEND_THIS));
+
     zend_update_property_double(H3_LatLng_ce, Z_OBJ_P(ZEND_THIS), "lat", sizeof("lat") - 1, lat);
     zend_update_property_double(H3_LatLng_ce, Z_OBJ_P(ZEND_THIS), "lon", sizeof("lon") - 1, lon);
 }
@@ -1924,6 +6952,8 @@ PHP_METHOD(H3_CellBoundary, __construct)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
+    h3_geometry_construct(Z_OBJ_P(ZEND_THIS));
+
     zend_update_property(H3_CellBoundary_ce, Z_OBJ_P(ZEND_THIS), "vertices", sizeof("vertices") - 1, vertices);
 }
 
@@ -1955,6 +6985,8 @@ PHP_METHOD(H3_GeoPolygon, __construct)
     ZEND_PARSE_PARAMETERS_END();
     // clang-format on
 
+    h3_geometry_construct(Z_OBJ_P(ZEND_THIS));
+
     ZVAL_OBJ(&geofence_val, geofence);
     zend_update_property(H3_GeoPolygon_ce, Z_OBJ_P(ZEND_THIS), "geofence", sizeof("geofence") - 1, &geofence_val);
 
@@ -1968,6 +7000,109 @@ PHP_METHOD(H3_GeoPolygon, __construct)
     }
 }
 
+PHP_METHOD(H3_GeoPolygon, fromGeoJson)
+{
+    zend_array *geometry;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY_HT(geometry)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    zval *type = zend_hash_str_find(geometry, "type", sizeof("type") - 1);
+    zval *coordinates = NULL;
+    zval geometry_val;
+    bool flat;
+
+    if (type) {
+        coordinates = zend_hash_str_find(geometry, "coordinates", sizeof("coordinates") - 1);
+        if (Z_TYPE_P(type) != IS_STRING || !zend_string_equals_literal(Z_STR_P(type), "Polygon") || !coordinates) {
+            zend_argument_error(H3_H3Exception_ce, 1, "must be a GeoJSON Polygon, or a flat array of coordinates");
+            RETURN_THROWS();
+        }
+        ZVAL_DEREF(coordinates);
+    } else {
+        ZVAL_ARR(&geometry_val, geometry);
+        coordinates = &geometry_val;
+    }
+
+    int depth = geo_json_depth(coordinates);
+    if (depth != 1 && depth != 3) {
+        zend_argument_error(H3_H3Exception_ce, 1, "must be a GeoJSON Polygon, or a flat array of coordinates");
+        RETURN_THROWS();
+    }
+    flat = depth == 1;
+
+    zend_object *obj = H3_GeoPolygon_ce->create_object(H3_GeoPolygon_ce);
+    h3_geo_polygon_object *intern = H3_OBJ(h3_geo_polygon_object, obj);
+    zend_array *rings = Z_ARR_P(coordinates);
+    uint32_t num_holes = flat ? 0 : zend_array_count(rings) - 1;
+    GeoLoop *holes = num_holes > 0 ? safe_emalloc(num_holes, sizeof(GeoLoop), 0) : NULL;
+    zval geofence_val;
+    zval holes_val;
+    zval vertices;
+    zval boundary_val;
+    zval *ring;
+    GeoLoop loop;
+    int idx = 0;
+
+    ZVAL_UNDEF(&geofence_val);
+    array_init_size(&holes_val, num_holes);
+
+    if (flat) {
+        if (geo_json_ring_to_geoloop(rings, true, &loop, &vertices) == 0) {
+            ZVAL_OBJ(&geofence_val, geoloop_to_boundary_obj(&loop, &vertices));
+            zval_ptr_dtor(&vertices);
+        }
+    } else {
+        ZEND_HASH_FOREACH_VAL(rings, ring)
+        {
+            ZVAL_DEREF(ring);
+            if (Z_TYPE_P(ring) != IS_ARRAY || geo_json_ring_to_geoloop(Z_ARR_P(ring), false, &loop, &vertices) != 0) {
+                break;
+            }
+
+            ZVAL_OBJ(&boundary_val, geoloop_to_boundary_obj(&loop, &vertices));
+            zval_ptr_dtor(&vertices);
+
+            if (idx++ == 0) {
+                ZVAL_COPY_VALUE(&geofence_val, &boundary_val);
+            } else {
+                holes[idx - 2] = loop;
+                add_next_index_zval(&holes_val, &boundary_val);
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    if (Z_TYPE(geofence_val) == IS_UNDEF || (!flat && idx != zend_array_count(rings))) {
+        zval_ptr_dtor(&geofence_val);
+        zval_ptr_dtor(&holes_val);
+        if (holes) {
+            efree(holes);
+        }
+        OBJ_RELEASE(obj);
+        zend_argument_error(H3_H3Exception_ce, 1, "must be a GeoJSON Polygon, or a flat array of coordinates");
+        RETURN_THROWS();
+    }
+
+    zend_update_property(H3_GeoPolygon_ce, obj, "geofence", sizeof("geofence") - 1, &geofence_val);
+    zend_update_property(H3_GeoPolygon_ce, obj, "holes", sizeof("holes") - 1, &holes_val);
+
+    intern->polygon.geoloop = H3_OBJ(h3_cell_boundary_object, Z_OBJ(geofence_val))->loop;
+    intern->polygon.numHoles = num_holes;
+    intern->polygon.holes = holes;
+    geoloop_to_bbox(&intern->polygon.geoloop, &intern->bbox);
+    intern->cached = true;
+    intern->epoch = H3_G(geometry_epoch);
+
+    zval_ptr_dtor(&geofence_val);
+    zval_ptr_dtor(&holes_val);
+
+    RETURN_OBJ(obj);
+}
+
 PHP_METHOD(H3_GeoPolygon, getGeofence)
 {
     ZEND_PARSE_PARAMETERS_NONE();
@@ -2033,6 +7168,28 @@ PHP_METHOD(H3_GeoMultiPolygon, toGeoJson)
     }
 }
 
+PHP_METHOD(H3_GeoMultiPolygon, toWkb)
+{
+    bool extended = false;
+
+    // clang-format off
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(extended)
+    ZEND_PARSE_PARAMETERS_END();
+    // clang-format on
+
+    smart_str buf = {0};
+
+    if (multi_polygon_obj_to_wkb(Z_OBJ_P(ZEND_THIS), &buf, extended) != 0) {
+        smart_str_free(&buf);
+        H3_THROW("Failed to build WKB MultiPolygon", 0);
+        RETURN_THROWS();
+    }
+
+    RETURN_STR(smart_str_extract(&buf));
+}
+
 PHP_METHOD(H3_CoordIJ, __construct)
 {
     zend_long i;
@@ -2077,6 +7234,8 @@ PHP_METHOD(H3_CoordIJ, getJ)
 PHP_INI_BEGIN()
     STD_PHP_INI_ENTRY("h3.validate_res", "On", PHP_INI_ALL, OnUpdateBool, validate_res, zend_h3_globals, h3_globals)
     STD_PHP_INI_ENTRY("h3.validate_index", "Off", PHP_INI_ALL, OnUpdateBool, validate_index, zend_h3_globals, h3_globals)
+    STD_PHP_INI_ENTRY("h3.threads", "1", PHP_INI_SYSTEM, OnUpdateLong, threads, zend_h3_globals, h3_globals)
+    STD_PHP_INI_ENTRY("h3.result_cache_size", "0", PHP_INI_SYSTEM, OnUpdateLong, result_cache_size, zend_h3_globals, h3_globals)
 PHP_INI_END()
 // clang-format on
 
@@ -2084,6 +7243,13 @@ PHP_MINIT_FUNCTION(h3)
 {
     REGISTER_INI_ENTRIES();
 
+    if (h3_tables_init() != E_SUCCESS) {
+        return FAILURE;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    h3_online_cpus = cpus < 1 ? 1 : (int) MIN(cpus, H3_MAX_THREADS);
+
     REGISTER_LONG_CONSTANT("H3_ERR_CODE_INVALID_RES", H3_ERR_CODE_INVALID_RES, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("H3_ERR_CODE_INVALID_INDEX", H3_ERR_CODE_INVALID_INDEX, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("H3_ERR_CODE_UNSUPPORTED_UNIT", H3_ERR_CODE_UNSUPPORTED_UNIT, CONST_PERSISTENT);
@@ -2100,6 +7266,18 @@ PHP_MINIT_FUNCTION(h3)
     REGISTER_LONG_CONSTANT("H3_LENGTH_UNIT_M", H3_LENGTH_UNIT_M, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("H3_LENGTH_UNIT_RADS", H3_LENGTH_UNIT_RADS, CONST_PERSISTENT);
 
+    REGISTER_LONG_CONSTANT("H3_DISTANCES_NESTED", H3_DISTANCES_NESTED, CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("H3_DISTANCES_MAP", H3_DISTANCES_MAP, CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("H3_DISTANCES_PACKED", H3_DISTANCES_PACKED, CONST_PERSISTENT);
+
+    REGISTER_LONG_CONSTANT("H3_OUTPUT_LIST", H3_OUTPUT_LIST, CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("H3_OUTPUT_SET", H3_OUTPUT_SET, CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("H3_OUTPUT_MAP", H3_OUTPUT_MAP, CONST_PERSISTENT);
+
+    REGISTER_LONG_CONSTANT("H3_ORDER_INDEX", H3_ORDER_INDEX, CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("H3_ORDER_MORTON", H3_ORDER_MORTON, CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("H3_ORDER_HILBERT", H3_ORDER_HILBERT, CONST_PERSISTENT);
+
     H3_H3Exception_ce = register_class_H3_H3Exception(spl_ce_RuntimeException);
     H3_H3Index_ce = register_class_H3_H3Index();
     H3_H3DirectedEdge_ce = register_class_H3_H3DirectedEdge();
@@ -2109,6 +7287,23 @@ PHP_MINIT_FUNCTION(h3)
     H3_GeoMultiPolygon_ce = register_class_H3_GeoMultiPolygon();
     H3_CoordIJ_ce = register_class_H3_CoordIJ();
 
+    H3_LatLng_ce->create_object = h3_lat_lng_create_object;
+    memcpy(&h3_lat_lng_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    h3_lat_lng_handlers.offset = XtOffsetOf(h3_lat_lng_object, std);
+    h3_lat_lng_handlers.clone_obj = h3_lat_lng_clone_obj;
+
+    H3_CellBoundary_ce->create_object = h3_cell_boundary_create_object;
+    memcpy(&h3_cell_boundary_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    h3_cell_boundary_handlers.offset = XtOffsetOf(h3_cell_boundary_object, std);
+    h3_cell_boundary_handlers.free_obj = h3_cell_boundary_free_obj;
+    h3_cell_boundary_handlers.clone_obj = h3_cell_boundary_clone_obj;
+
+    H3_GeoPolygon_ce->create_object = h3_geo_polygon_create_object;
+    memcpy(&h3_geo_polygon_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    h3_geo_polygon_handlers.offset = XtOffsetOf(h3_geo_polygon_object, std);
+    h3_geo_polygon_handlers.free_obj = h3_geo_polygon_free_obj;
+    h3_geo_polygon_handlers.clone_obj = h3_geo_polygon_clone_obj;
+
     return SUCCESS;
 }
 
@@ -2128,6 +7323,13 @@ PHP_RINIT_FUNCTION(h3)
     return SUCCESS;
 }
 
+PHP_RSHUTDOWN_FUNCTION(h3)
+{
+    h3_scratch_free();
+
+    return SUCCESS;
+}
+
 PHP_MINFO_FUNCTION(h3)
 {
     php_info_print_table_start();
@@ -2147,6 +7349,13 @@ PHP_GINIT_FUNCTION(h3)
     memset(h3_globals, 0, sizeof(zend_h3_globals));
 }
 
+PHP_GSHUTDOWN_FUNCTION(h3)
+{
+    if (h3_globals->result_cache) {
+        h3_result_cache_free(h3_globals->result_cache);
+    }
+}
+
 // clang-format off
 zend_module_entry h3_module_entry = {
     STANDARD_MODULE_HEADER,
@@ -2155,12 +7364,12 @@ zend_module_entry h3_module_entry = {
     PHP_MINIT(h3),
     PHP_MSHUTDOWN(h3),
     PHP_RINIT(h3),
-    NULL,
+    PHP_RSHUTDOWN(h3),
     PHP_MINFO(h3),
     PHP_H3_VERSION,
     PHP_MODULE_GLOBALS(h3),
     PHP_GINIT(h3),
-    NULL,
+    PHP_GSHUTDOWN(h3),
     NULL,
     STANDARD_MODULE_PROPERTIES_EX
 };
@@ -37,7 +37,11 @@ function get_pentagon_indexes(int $res): array {}
 function point_dist(LatLng $a, LatLng $b, int $unit): float {}
 
 /**
- * @param H3Index[] $indexes
+ * Strictly increasing cells of a single resolution, as returned by
+ * unique_cells(), are compacted in a single pass per resolution without
+ * going through libh3.
+ *
+ * @param array<H3Index|int> $indexes
  * @return H3Index[]
  * @throws H3Exception
  */
@@ -45,10 +49,12 @@ function compact(array $indexes): array {}
 
 /**
  * @param H3Index[] $indexes
- * @return H3Index[]
+ * @param int $output H3_OUTPUT_LIST for a list, or H3_OUTPUT_SET / H3_OUTPUT_MAP for an array keyed by
+ *                    integer index with true / the H3Index object as values
+ * @return H3Index[]|array<int, true|H3Index>
  * @throws H3Exception if invalid resolution given
  */
-function uncompact(array $indexes, int $res): array {}
+function uncompact(array $indexes, int $res, int $output = H3_OUTPUT_LIST): array {}
 
 /**
  * @return H3Index[]
@@ -61,10 +67,37 @@ function distance(H3Index $a, H3Index $b): int {}
 function indexes_are_neighbors(H3Index $origin, H3Index $destination): bool {}
 
 /**
- * @return H3Index[]
+ * @param GeoPolygon|array $polygon a GeoPolygon, a GeoJSON Polygon or MultiPolygon geometry or its coordinates,
+ *                                  or a flat [lon, lat, lon, lat, ...] array
+ * @param int $output H3_OUTPUT_LIST for a list, or H3_OUTPUT_SET / H3_OUTPUT_MAP for an array keyed by
+ *                    integer index with true / the H3Index object as values
+ * @return H3Index[]|array<int, true|H3Index>
  * @throws H3Exception
  */
-function polyfill(GeoPolygon $polygon, int $res): array {}
+function polyfill(GeoPolygon|array $polygon, int $res, int $output = H3_OUTPUT_LIST): array {}
+
+/**
+ * Polyfills at the finest resolution that needs at most $max_cells cells. With $mixed, finer resolutions are
+ * tried as well: their cells are compacted and, if still too many, the finest ones are merged into their
+ * parents until the result fits. Mixed results are in hierarchy order.
+ *
+ * @param GeoPolygon|array $polygon as for polyfill()
+ * @return H3Index[]
+ * @throws H3Exception if the polygon needs more than $max_cells cells at resolution 0
+ */
+function polyfill_budget(GeoPolygon|array $polygon, int $max_cells, bool $mixed = false): array {}
+
+/**
+ * Counters of the polyfill() result cache, enabled by the h3.result_cache_size INI setting.
+ *
+ * @return array{entries: int, bytes: int, max_bytes: int, hits: int, misses: int, evictions: int}
+ */
+function result_cache_stats(): array {}
+
+/**
+ * Drops all cached polyfill() results and resets the counters.
+ */
+function result_cache_clear(): void {}
 
 /**
  * @param H3Index[] $indexes
@@ -72,6 +105,266 @@ function polyfill(GeoPolygon $polygon, int $res): array {}
  */
 function h3_set_to_multi_polygon(array $indexes): GeoMultiPolygon {}
 
+/**
+ * @param H3Index[] $indexes
+ * @param resource|null $stream
+ * @return string|int GeoJSON MultiPolygon geometry, or the number of bytes written to $stream
+ * @throws H3Exception
+ */
+function h3_set_to_geo_json(array $indexes, $stream = null): string|int {}
+
+/**
+ * @param array<H3Index|int> $indexes
+ * @param array<array|null>|null $properties per-cell properties, looked up by the key of the cell in $indexes
+ * @param resource|null $stream
+ * @return string|int GeoJSON FeatureCollection, or the number of bytes written to $stream
+ * @throws H3Exception
+ */
+function cells_to_geo_json_features(array $indexes, ?array $properties = null, $stream = null): string|int {}
+
+/**
+ * @param H3Index[] $indexes
+ * @param bool $extended write EWKB with SRID 4326
+ * @return string WKB MultiPolygon
+ * @throws H3Exception
+ */
+function h3_set_to_wkb(array $indexes, bool $extended = false): string {}
+
+/**
+ * @param array<H3Index|int> $indexes
+ * @param bool $multi return a single WKB MultiPolygon instead of one WKB Polygon per cell
+ * @param bool $extended write EWKB with SRID 4326
+ * @return string[]|string
+ * @throws H3Exception
+ */
+function cells_to_wkb(array $indexes, bool $multi = false, bool $extended = false): array|string {}
+
+/**
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $packed return a string of native-endian doubles instead of an array
+ * @return float[]|string cell centers as flat lon/lat pairs in degrees
+ * @throws H3Exception
+ */
+function cells_to_centers(array|string $indexes, bool $packed = false): array|string {}
+
+/**
+ * Vertex i of cell n is at coordinates[2 * i] and coordinates[2 * i + 1] for
+ * offsets[n] <= i < offsets[n + 1].
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $packed return native-endian doubles and uint32 offsets as strings instead of arrays
+ * @return array{coordinates: float[]|string, offsets: int[]|string} boundary vertices as flat lon/lat pairs in degrees
+ * @throws H3Exception
+ */
+function cells_to_boundaries(array|string $indexes, bool $packed = false): array {}
+
+/**
+ * Decodes per-cell metadata into one column per field. faces holds a bitmask
+ * of the icosahedron faces the cell touches.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $packed return unsigned bytes (and native-endian uint32 faces) as strings instead of arrays
+ * @return array{resolution: int[]|string, base_cell: int[]|string, is_pentagon: int[]|string, is_class_iii: int[]|string, faces: int[]|string}
+ * @throws H3Exception
+ */
+function decode_cells(array|string $indexes, bool $packed = false): array {}
+
+/**
+ * Checks every entry with the same rules as H3Index::isValid(), without
+ * constructing objects.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $bitmap return a bitmap with bit i (least significant first) set when entry i is invalid
+ * @return int[]|string positions of the invalid entries, or the bitmap
+ * @throws H3Exception
+ */
+function validate_cells(array|string $indexes, bool $bitmap = false): array|string {}
+
+/**
+ * @param int[]|string $indexes directed edge ids, or a string of native-endian 64-bit indexes
+ * @param bool $bitmap see validate_cells()
+ * @return int[]|string positions of the invalid entries, or the bitmap
+ * @throws H3Exception
+ */
+function validate_directed_edges(array|string $indexes, bool $bitmap = false): array|string {}
+
+/**
+ * @param H3Index[]|int[]|string $indexes cells or directed edges, or a string of native-endian 64-bit indexes
+ * @param bool $joined return a single newline-separated string instead of an array
+ * @return string[]|string lowercase hex ids, as H3Index::toString() gives them
+ * @throws H3Exception
+ */
+function cells_to_strings(array|string $indexes, bool $joined = false): array|string {}
+
+/**
+ * Each id is 1 to 16 hex digits in either case, with no 0x prefix or
+ * surrounding whitespace, whether it is an array element or a line.
+ *
+ * @param string[]|string $strings hex ids, or a string with one hex id per line (blank lines and \r\n are accepted)
+ * @param bool $packed return a string of native-endian 64-bit indexes instead of an array of integers
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function strings_to_cells(array|string $strings, bool $packed = false): array|string {}
+
+/**
+ * Like H3Index::toParent() for every entry. With $counts, returns the distinct
+ * parents in order of first appearance and how many entries map to each.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $packed return native-endian 64-bit indexes (and uint32 counts) as strings instead of arrays
+ * @return int[]|string|array{parents: int[]|string, counts: int[]|string}
+ * @throws H3Exception
+ */
+function cells_to_parents(array|string $indexes, int $res, bool $packed = false, bool $counts = false): array|string {}
+
+/**
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $packed return native-endian 64-bit indexes as a string instead of an array
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function cells_to_center_children(array|string $indexes, int $res, bool $packed = false): array|string {}
+
+/**
+ * An index counts as its own descendant.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $bitmap see validate_cells()
+ * @return int[]|string positions of the descendants of $ancestor, or the bitmap
+ * @throws H3Exception
+ */
+function find_descendants(array|string $indexes, H3Index $ancestor, bool $bitmap = false): array|string {}
+
+/**
+ * Set operations work on the cell hierarchy directly, so neither input needs
+ * to be uncompacted. Inputs may mix resolutions and overlap; the result is
+ * compacted and in hierarchy order, each cell right before its descendants.
+ * Either input holding anything other than valid cells throws.
+ *
+ * @param array<H3Index|int>|string $a cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param array<H3Index|int>|string $b cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param bool $packed return native-endian 64-bit indexes as a string instead of an array
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function cells_union(array|string $a, array|string $b, bool $packed = false): array|string {}
+
+/**
+ * @param array<H3Index|int>|string $a see cells_union()
+ * @param array<H3Index|int>|string $b see cells_union()
+ * @param bool $packed see cells_union()
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function cells_intersection(array|string $a, array|string $b, bool $packed = false): array|string {}
+
+/**
+ * Cells of $a are split only where they contain part of $b.
+ *
+ * @param array<H3Index|int>|string $a see cells_union()
+ * @param array<H3Index|int>|string $b see cells_union()
+ * @param bool $packed see cells_union()
+ * @return int[]|string the area of $a outside $b
+ * @throws H3Exception
+ */
+function cells_difference(array|string $a, array|string $b, bool $packed = false): array|string {}
+
+/**
+ * @param array<H3Index|int>|string $a see cells_union()
+ * @param array<H3Index|int>|string $b see cells_union()
+ * @return bool whether $a covers all of $b
+ * @throws H3Exception
+ */
+function cells_contain(array|string $a, array|string $b): bool {}
+
+/**
+ * H3_ORDER_INDEX sorts by the 64-bit index, which keeps children of the same
+ * parent together. H3_ORDER_MORTON and H3_ORDER_HILBERT sort by the position
+ * of the cell center along a Z-order or Hilbert curve, which also keeps
+ * neighbors across base cells close. The Hilbert curve has no long jumps
+ * between consecutive positions, so it gives the better locality of the two.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param int $order one of H3_ORDER_INDEX, H3_ORDER_MORTON, or H3_ORDER_HILBERT
+ * @param bool $packed return native-endian 64-bit indexes as a string instead of an array
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function sort_cells(array|string $indexes, int $order = H3_ORDER_INDEX, bool $packed = false): array|string {}
+
+/**
+ * Like sort_cells(), keeping each cell once.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param int $order one of H3_ORDER_INDEX, H3_ORDER_MORTON, or H3_ORDER_HILBERT
+ * @param bool $packed return native-endian 64-bit indexes as a string instead of an array
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function unique_cells(array|string $indexes, int $order = H3_ORDER_INDEX, bool $packed = false): array|string {}
+
+/**
+ * Keys sort_cells() orders by, as non-negative integers, e.g. for range
+ * partitioning in external stores.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param int $order one of H3_ORDER_INDEX, H3_ORDER_MORTON, or H3_ORDER_HILBERT
+ * @param bool $packed return native-endian 64-bit keys as a string instead of an array
+ * @return int[]|string
+ * @throws H3Exception
+ */
+function cells_to_sort_keys(array|string $indexes, int $order = H3_ORDER_HILBERT, bool $packed = false): array|string {}
+
+/**
+ * Cells are connected when they are within k grid steps of each other.
+ * Components are numbered in the order their first cell appears.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param int $k grid distance, from 0 to 1000
+ * @param bool $grouped return the cells of each component instead of a label per cell
+ * @return int[]|H3Index[][] component label of each cell, or the cells of each component
+ * @throws H3Exception
+ */
+function connected_components(array|string $indexes, int $k = 1, bool $grouped = false): array {}
+
+/**
+ * Grows the cells by k rings at the finest input resolution. Compacted input
+ * is only refined near its edge.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param int $k rings, from 0 to 1000 and at most the size of the grid at the finest input resolution
+ * @param bool $compact return compacted cells instead of cells at the finest input resolution
+ * @return H3Index[]
+ * @throws H3Exception
+ */
+function dilate(array|string $indexes, int $k, bool $compact = false): array {}
+
+/**
+ * Keeps the cells whose k-ring lies inside the set at the finest input
+ * resolution. Compacted input is only refined near its edge.
+ *
+ * @param array<H3Index|int>|string $indexes cells, or a string of native-endian 64-bit indexes as produced by pack('Q*')
+ * @param int $k rings, from 0 to 1000 and at most the size of the grid at the finest input resolution
+ * @param bool $compact return compacted cells instead of cells at the finest input resolution
+ * @return H3Index[]
+ * @throws H3Exception
+ */
+function erode(array|string $indexes, int $k, bool $compact = false): array {}
+
+/**
+ * Convolves per-cell values with a kernel over the k-ring. A cell's result is
+ * the sum of weights[d] * value over the cells of the map at grid distance d,
+ * divided by the sum of those weights when normalizing.
+ *
+ * @param array<int|string, int|float> $values values keyed by H3 index as an integer or hex string
+ * @param int $k rings, from 0 to 1000 and at most the size of the grid at the finest input resolution
+ * @param float[]|null $weights k + 1 weights for rings 0 to k, 1 for every ring by default
+ * @return array<int|string, float> smoothed values under the same keys
+ * @throws H3Exception
+ */
+function smooth(array $values, int $k, ?array $weights = null, bool $normalize = true): array {}
+
 function experimental_h3_to_local_ij(H3Index $origin, H3Index $h): CoordIJ {}
 
 function experimental_local_ij_to_h3(H3Index $origin, CoordIJ $ij): H3Index {}
@@ -109,14 +402,17 @@ final class H3Index {
     public function getFaces(): array {}
 
     /**
-     * @return H3Index[]
+     * @param int $output see uncompact()
+     * @return H3Index[]|array<int, true|H3Index>
      */
-    public function kRing(int $k): array {}
+    public function kRing(int $k, int $output = H3_OUTPUT_LIST): array {}
 
     /**
-     * @return H3Index[][]
+     * @param int $format H3_DISTANCES_NESTED for cells grouped by distance, H3_DISTANCES_MAP for
+     *                    an index => distance map, or H3_DISTANCES_PACKED for parallel integer arrays
+     * @return H3Index[][]|array<int, int>|array{cells: int[], distances: int[]}
      */
-    public function kRingDistances(int $k): array {}
+    public function kRingDistances(int $k, int $format = H3_DISTANCES_NESTED): array {}
 
     /**
      * @return H3Index[]
@@ -131,15 +427,21 @@ final class H3Index {
     public function hexRing(int $k): array {}
 
     /**
-     * @return H3Index[][]
+     * @param int $format see kRingDistances()
+     * @return H3Index[][]|array<int, int>|array{cells: int[], distances: int[]}
      * @throws H3Exception if pentagonal distortion is encountered
      */
-    public function hexRangeDistances(int $k): array {}
+    public function hexRangeDistances(int $k, int $format = H3_DISTANCES_NESTED): array {}
 
     public function getCellArea(int $unit): float {}
 
     public function isNeighborTo(H3Index $destination): bool {}
 
+    /**
+     * @param array<int, mixed> $set array keyed by integer index, as returned with H3_OUTPUT_SET or H3_OUTPUT_MAP
+     */
+    public function isIn(array $set): bool {}
+
     /**
      * @return H3Index[]
      */
@@ -160,10 +462,11 @@ final class H3Index {
     public function toParent(int $res): H3Index {}
 
     /**
-     * @return H3Index[]
+     * @param int $output see uncompact()
+     * @return H3Index[]|array<int, true|H3Index>
      * @throws H3Exception if invalid resolution given
      */
-    public function toChildren(int $res): array {}
+    public function toChildren(int $res, int $output = H3_OUTPUT_LIST): array {}
 
     /**
      * @throws H3Exception if invalid resolution given
@@ -178,6 +481,13 @@ final class H3Index {
 
     public function toGeoBoundary(): CellBoundary {}
 
+    /**
+     * @param bool $extended write EWKB with SRID 4326
+     * @return string WKB Polygon
+     * @throws H3Exception
+     */
+    public function toWkb(bool $extended = false): string {}
+
     public function __toString(): string {}
 }
 
@@ -258,6 +568,12 @@ final class GeoPolygon {
      */
     public function __construct(CellBoundary $geofence, array $holes = []) {}
 
+    /**
+     * @param array $geometry a GeoJSON Polygon geometry or its coordinates, or a flat [lon, lat, lon, lat, ...] array
+     * @throws H3Exception
+     */
+    public static function fromGeoJson(array $geometry): GeoPolygon {}
+
     public function getGeofence(): CellBoundary {}
 
     /**
@@ -288,6 +604,13 @@ final class GeoMultiPolygon {
      * @throws H3Exception if this object is not valid
      */
     public function toGeoJson(): array {}
+
+    /**
+     * @param bool $extended write EWKB with SRID 4326
+     * @return string WKB MultiPolygon
+     * @throws H3Exception if this object is not valid
+     */
+    public function toWkb(bool $extended = false): string {}
 }
 
 final class CoordIJ {
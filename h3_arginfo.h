@@ -40,6 +40,7 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_uncompact, 0, 2, IS_ARRAY, 0)
 	ZEND_ARG_TYPE_INFO(0, indexes, IS_ARRAY, 0)
 	ZEND_ARG_TYPE_INFO(0, res, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, output, IS_LONG, 0, "H3_OUTPUT_LIST")
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_line, 0, 2, IS_ARRAY, 0)
@@ -58,14 +59,147 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_indexes_are_neighbors, 0, 2,
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_polyfill, 0, 2, IS_ARRAY, 0)
-	ZEND_ARG_OBJ_INFO(0, polygon, H3\\GeoPolygon, 0)
+	ZEND_ARG_OBJ_TYPE_MASK(0, polygon, H3\\GeoPolygon, MAY_BE_ARRAY, NULL)
 	ZEND_ARG_TYPE_INFO(0, res, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, output, IS_LONG, 0, "H3_OUTPUT_LIST")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_polyfill_budget, 0, 2, IS_ARRAY, 0)
+	ZEND_ARG_OBJ_TYPE_MASK(0, polygon, H3\\GeoPolygon, MAY_BE_ARRAY, NULL)
+	ZEND_ARG_TYPE_INFO(0, max_cells, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, mixed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_result_cache_stats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_result_cache_clear, 0, 0, IS_VOID, 0)
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_H3_h3_set_to_multi_polygon, 0, 1, H3\\GeoMultiPolygon, 0)
 	ZEND_ARG_TYPE_INFO(0, indexes, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_h3_set_to_geo_json, 0, 1, MAY_BE_STRING|MAY_BE_LONG)
+	ZEND_ARG_TYPE_INFO(0, indexes, IS_ARRAY, 0)
+	ZEND_ARG_INFO_WITH_DEFAULT_VALUE(0, stream, "null")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_geo_json_features, 0, 1, MAY_BE_STRING|MAY_BE_LONG)
+	ZEND_ARG_TYPE_INFO(0, indexes, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, properties, IS_ARRAY, 1, "null")
+	ZEND_ARG_INFO_WITH_DEFAULT_VALUE(0, stream, "null")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_h3_set_to_wkb, 0, 1, IS_STRING, 0)
+	ZEND_ARG_TYPE_INFO(0, indexes, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, extended, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_wkb, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_INFO(0, indexes, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, multi, _IS_BOOL, 0, "false")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, extended, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_centers, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_cells_to_boundaries, 0, 1, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+#define arginfo_H3_decode_cells arginfo_H3_cells_to_boundaries
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_validate_cells, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, bitmap, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+#define arginfo_H3_validate_directed_edges arginfo_H3_validate_cells
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_strings, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, joined, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_strings_to_cells, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, strings, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_parents, 0, 2, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO(0, res, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, counts, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_center_children, 0, 2, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO(0, res, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_sort_cells, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, order, IS_LONG, 0, "H3_ORDER_INDEX")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+#define arginfo_H3_unique_cells arginfo_H3_sort_cells
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_to_sort_keys, 0, 1, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, order, IS_LONG, 0, "H3_ORDER_HILBERT")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_cells_union, 0, 2, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, a, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_MASK(0, b, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, packed, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+#define arginfo_H3_cells_intersection arginfo_H3_cells_union
+
+#define arginfo_H3_cells_difference arginfo_H3_cells_union
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_cells_contain, 0, 2, _IS_BOOL, 0)
+	ZEND_ARG_TYPE_MASK(0, a, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_MASK(0, b, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_H3_find_descendants, 0, 2, MAY_BE_ARRAY|MAY_BE_STRING)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_OBJ_INFO(0, ancestor, H3\\H3Index, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, bitmap, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_connected_components, 0, 1, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, k, IS_LONG, 0, "1")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, grouped, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_dilate, 0, 2, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_MASK(0, indexes, MAY_BE_ARRAY|MAY_BE_STRING, NULL)
+	ZEND_ARG_TYPE_INFO(0, k, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, compact, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+#define arginfo_H3_erode arginfo_H3_dilate
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_H3_smooth, 0, 2, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, values, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, k, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, weights, IS_ARRAY, 1, "null")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, normalize, _IS_BOOL, 0, "true")
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_H3_experimental_h3_to_local_ij, 0, 2, H3\\CoordIJ, 0)
 	ZEND_ARG_OBJ_INFO(0, origin, H3\\H3Index, 0)
 	ZEND_ARG_OBJ_INFO(0, h, H3\\H3Index, 0)
@@ -109,15 +243,21 @@ ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_kRing, 0, 1, IS_ARRAY, 0)
 	ZEND_ARG_TYPE_INFO(0, k, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, output, IS_LONG, 0, "H3_OUTPUT_LIST")
 ZEND_END_ARG_INFO()
 
-#define arginfo_class_H3_H3Index_kRingDistances arginfo_class_H3_H3Index_kRing
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_kRingDistances, 0, 1, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, k, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, format, IS_LONG, 0, "H3_DISTANCES_NESTED")
+ZEND_END_ARG_INFO()
 
-#define arginfo_class_H3_H3Index_hexRange arginfo_class_H3_H3Index_kRing
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_hexRange, 0, 1, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, k, IS_LONG, 0)
+ZEND_END_ARG_INFO()
 
-#define arginfo_class_H3_H3Index_hexRing arginfo_class_H3_H3Index_kRing
+#define arginfo_class_H3_H3Index_hexRing arginfo_class_H3_H3Index_hexRange
 
-#define arginfo_class_H3_H3Index_hexRangeDistances arginfo_class_H3_H3Index_kRing
+#define arginfo_class_H3_H3Index_hexRangeDistances arginfo_class_H3_H3Index_kRingDistances
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_getCellArea, 0, 1, IS_DOUBLE, 0)
 	ZEND_ARG_TYPE_INFO(0, unit, IS_LONG, 0)
@@ -127,6 +267,10 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_isNeighborTo, 0
 	ZEND_ARG_OBJ_INFO(0, destination, H3\\H3Index, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_isIn, 0, 1, _IS_BOOL, 0)
+	ZEND_ARG_TYPE_INFO(0, set, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_getLineTo, 0, 1, IS_ARRAY, 0)
 	ZEND_ARG_OBJ_INFO(0, destination, H3\\H3Index, 0)
 ZEND_END_ARG_INFO()
@@ -145,7 +289,10 @@ ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_class_H3_H3Index_toParent, 0, 1,
 	ZEND_ARG_TYPE_INFO(0, res, IS_LONG, 0)
 ZEND_END_ARG_INFO()
 
-#define arginfo_class_H3_H3Index_toChildren arginfo_H3_get_pentagon_indexes
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_toChildren, 0, 1, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, res, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, output, IS_LONG, 0, "H3_OUTPUT_LIST")
+ZEND_END_ARG_INFO()
 
 #define arginfo_class_H3_H3Index_toCenterChild arginfo_class_H3_H3Index_toParent
 
@@ -160,6 +307,10 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_class_H3_H3Index_toGeoBoundary, 0, 0, H3\\CellBoundary, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_H3_H3Index_toWkb, 0, 0, IS_STRING, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, extended, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
 #define arginfo_class_H3_H3Index___toString arginfo_class_H3_H3Index_toString
 
 #define arginfo_class_H3_H3DirectedEdge___construct arginfo_class_H3_H3Index___construct
@@ -212,6 +363,10 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_class_H3_GeoPolygon___construct, 0, 0, 1)
 	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, holes, IS_ARRAY, 0, "[]")
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_class_H3_GeoPolygon_fromGeoJson, 0, 1, H3\\GeoPolygon, 0)
+	ZEND_ARG_TYPE_INFO(0, geometry, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
 #define arginfo_class_H3_GeoPolygon_getGeofence arginfo_class_H3_H3Index_toGeoBoundary
 
 #define arginfo_class_H3_GeoPolygon_getHoles arginfo_H3_get_res0_indexes
@@ -224,6 +379,8 @@ ZEND_END_ARG_INFO()
 
 #define arginfo_class_H3_GeoMultiPolygon_toGeoJson arginfo_H3_get_res0_indexes
 
+#define arginfo_class_H3_GeoMultiPolygon_toWkb arginfo_class_H3_H3Index_toWkb
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_class_H3_CoordIJ___construct, 0, 0, 2)
 	ZEND_ARG_TYPE_INFO(0, i, IS_LONG, 0)
 	ZEND_ARG_TYPE_INFO(0, j, IS_LONG, 0)
@@ -248,7 +405,35 @@ ZEND_FUNCTION(line);
 ZEND_FUNCTION(distance);
 ZEND_FUNCTION(indexes_are_neighbors);
 ZEND_FUNCTION(polyfill);
+ZEND_FUNCTION(polyfill_budget);
+ZEND_FUNCTION(result_cache_stats);
+ZEND_FUNCTION(result_cache_clear);
 ZEND_FUNCTION(h3_set_to_multi_polygon);
+ZEND_FUNCTION(h3_set_to_geo_json);
+ZEND_FUNCTION(cells_to_geo_json_features);
+ZEND_FUNCTION(h3_set_to_wkb);
+ZEND_FUNCTION(cells_to_wkb);
+ZEND_FUNCTION(cells_to_centers);
+ZEND_FUNCTION(cells_to_boundaries);
+ZEND_FUNCTION(decode_cells);
+ZEND_FUNCTION(validate_cells);
+ZEND_FUNCTION(validate_directed_edges);
+ZEND_FUNCTION(cells_to_strings);
+ZEND_FUNCTION(strings_to_cells);
+ZEND_FUNCTION(cells_to_parents);
+ZEND_FUNCTION(cells_to_center_children);
+ZEND_FUNCTION(find_descendants);
+ZEND_FUNCTION(cells_union);
+ZEND_FUNCTION(cells_intersection);
+ZEND_FUNCTION(cells_difference);
+ZEND_FUNCTION(cells_contain);
+ZEND_FUNCTION(sort_cells);
+ZEND_FUNCTION(unique_cells);
+ZEND_FUNCTION(cells_to_sort_keys);
+ZEND_FUNCTION(connected_components);
+ZEND_FUNCTION(dilate);
+ZEND_FUNCTION(erode);
+ZEND_FUNCTION(smooth);
 ZEND_FUNCTION(experimental_h3_to_local_ij);
 ZEND_FUNCTION(experimental_local_ij_to_h3);
 ZEND_METHOD(H3_H3Index, __construct);
@@ -268,6 +453,7 @@ ZEND_METHOD(H3_H3Index, hexRing);
 ZEND_METHOD(H3_H3Index, hexRangeDistances);
 ZEND_METHOD(H3_H3Index, getCellArea);
 ZEND_METHOD(H3_H3Index, isNeighborTo);
+ZEND_METHOD(H3_H3Index, isIn);
 ZEND_METHOD(H3_H3Index, getLineTo);
 ZEND_METHOD(H3_H3Index, getDistanceTo);
 ZEND_METHOD(H3_H3Index, getDirectedEdges);
@@ -279,6 +465,7 @@ ZEND_METHOD(H3_H3Index, toLong);
 ZEND_METHOD(H3_H3Index, toString);
 ZEND_METHOD(H3_H3Index, toGeo);
 ZEND_METHOD(H3_H3Index, toGeoBoundary);
+ZEND_METHOD(H3_H3Index, toWkb);
 ZEND_METHOD(H3_H3Index, __toString);
 ZEND_METHOD(H3_H3DirectedEdge, __construct);
 ZEND_METHOD(H3_H3DirectedEdge, fromLong);
@@ -298,11 +485,13 @@ ZEND_METHOD(H3_LatLng, getLon);
 ZEND_METHOD(H3_CellBoundary, __construct);
 ZEND_METHOD(H3_CellBoundary, getVertices);
 ZEND_METHOD(H3_GeoPolygon, __construct);
+ZEND_METHOD(H3_GeoPolygon, fromGeoJson);
 ZEND_METHOD(H3_GeoPolygon, getGeofence);
 ZEND_METHOD(H3_GeoPolygon, getHoles);
 ZEND_METHOD(H3_GeoMultiPolygon, __construct);
 ZEND_METHOD(H3_GeoMultiPolygon, getPolygons);
 ZEND_METHOD(H3_GeoMultiPolygon, toGeoJson);
+ZEND_METHOD(H3_GeoMultiPolygon, toWkb);
 ZEND_METHOD(H3_CoordIJ, __construct);
 ZEND_METHOD(H3_CoordIJ, getI);
 ZEND_METHOD(H3_CoordIJ, getJ);
@@ -323,7 +512,35 @@ static const zend_function_entry ext_functions[] = {
 	ZEND_NS_FE("H3", distance, arginfo_H3_distance)
 	ZEND_NS_FE("H3", indexes_are_neighbors, arginfo_H3_indexes_are_neighbors)
 	ZEND_NS_FE("H3", polyfill, arginfo_H3_polyfill)
+	ZEND_NS_FE("H3", polyfill_budget, arginfo_H3_polyfill_budget)
+	ZEND_NS_FE("H3", result_cache_stats, arginfo_H3_result_cache_stats)
+	ZEND_NS_FE("H3", result_cache_clear, arginfo_H3_result_cache_clear)
 	ZEND_NS_FE("H3", h3_set_to_multi_polygon, arginfo_H3_h3_set_to_multi_polygon)
+	ZEND_NS_FE("H3", h3_set_to_geo_json, arginfo_H3_h3_set_to_geo_json)
+	ZEND_NS_FE("H3", cells_to_geo_json_features, arginfo_H3_cells_to_geo_json_features)
+	ZEND_NS_FE("H3", h3_set_to_wkb, arginfo_H3_h3_set_to_wkb)
+	ZEND_NS_FE("H3", cells_to_wkb, arginfo_H3_cells_to_wkb)
+	ZEND_NS_FE("H3", cells_to_centers, arginfo_H3_cells_to_centers)
+	ZEND_NS_FE("H3", cells_to_boundaries, arginfo_H3_cells_to_boundaries)
+	ZEND_NS_FE("H3", decode_cells, arginfo_H3_decode_cells)
+	ZEND_NS_FE("H3", validate_cells, arginfo_H3_validate_cells)
+	ZEND_NS_FE("H3", validate_directed_edges, arginfo_H3_validate_directed_edges)
+	ZEND_NS_FE("H3", cells_to_strings, arginfo_H3_cells_to_strings)
+	ZEND_NS_FE("H3", strings_to_cells, arginfo_H3_strings_to_cells)
+	ZEND_NS_FE("H3", cells_to_parents, arginfo_H3_cells_to_parents)
+	ZEND_NS_FE("H3", cells_to_center_children, arginfo_H3_cells_to_center_children)
+	ZEND_NS_FE("H3", find_descendants, arginfo_H3_find_descendants)
+	ZEND_NS_FE("H3", cells_union, arginfo_H3_cells_union)
+	ZEND_NS_FE("H3", cells_intersection, arginfo_H3_cells_intersection)
+	ZEND_NS_FE("H3", cells_difference, arginfo_H3_cells_difference)
+	ZEND_NS_FE("H3", cells_contain, arginfo_H3_cells_contain)
+	ZEND_NS_FE("H3", sort_cells, arginfo_H3_sort_cells)
+	ZEND_NS_FE("H3", unique_cells, arginfo_H3_unique_cells)
+	ZEND_NS_FE("H3", cells_to_sort_keys, arginfo_H3_cells_to_sort_keys)
+	ZEND_NS_FE("H3", connected_components, arginfo_H3_connected_components)
+	ZEND_NS_FE("H3", dilate, arginfo_H3_dilate)
+	ZEND_NS_FE("H3", erode, arginfo_H3_erode)
+	ZEND_NS_FE("H3", smooth, arginfo_H3_smooth)
 	ZEND_NS_FE("H3", experimental_h3_to_local_ij, arginfo_H3_experimental_h3_to_local_ij)
 	ZEND_NS_FE("H3", experimental_local_ij_to_h3, arginfo_H3_experimental_local_ij_to_h3)
 	ZEND_FE_END
@@ -353,6 +570,7 @@ static const zend_function_entry class_H3_H3Index_methods[] = {
 	ZEND_ME(H3_H3Index, hexRangeDistances, arginfo_class_H3_H3Index_hexRangeDistances, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, getCellArea, arginfo_class_H3_H3Index_getCellArea, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, isNeighborTo, arginfo_class_H3_H3Index_isNeighborTo, ZEND_ACC_PUBLIC)
+	ZEND_ME(H3_H3Index, isIn, arginfo_class_H3_H3Index_isIn, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, getLineTo, arginfo_class_H3_H3Index_getLineTo, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, getDistanceTo, arginfo_class_H3_H3Index_getDistanceTo, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, getDirectedEdges, arginfo_class_H3_H3Index_getDirectedEdges, ZEND_ACC_PUBLIC)
@@ -364,6 +582,7 @@ static const zend_function_entry class_H3_H3Index_methods[] = {
 	ZEND_ME(H3_H3Index, toString, arginfo_class_H3_H3Index_toString, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, toGeo, arginfo_class_H3_H3Index_toGeo, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, toGeoBoundary, arginfo_class_H3_H3Index_toGeoBoundary, ZEND_ACC_PUBLIC)
+	ZEND_ME(H3_H3Index, toWkb, arginfo_class_H3_H3Index_toWkb, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_H3Index, __toString, arginfo_class_H3_H3Index___toString, ZEND_ACC_PUBLIC)
 	ZEND_FE_END
 };
@@ -403,6 +622,7 @@ static const zend_function_entry class_H3_CellBoundary_methods[] = {
 
 static const zend_function_entry class_H3_GeoPolygon_methods[] = {
 	ZEND_ME(H3_GeoPolygon, __construct, arginfo_class_H3_GeoPolygon___construct, ZEND_ACC_PUBLIC)
+	ZEND_ME(H3_GeoPolygon, fromGeoJson, arginfo_class_H3_GeoPolygon_fromGeoJson, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	ZEND_ME(H3_GeoPolygon, getGeofence, arginfo_class_H3_GeoPolygon_getGeofence, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_GeoPolygon, getHoles, arginfo_class_H3_GeoPolygon_getHoles, ZEND_ACC_PUBLIC)
 	ZEND_FE_END
@@ -413,6 +633,7 @@ static const zend_function_entry class_H3_GeoMultiPolygon_methods[] = {
 	ZEND_ME(H3_GeoMultiPolygon, __construct, arginfo_class_H3_GeoMultiPolygon___construct, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_GeoMultiPolygon, getPolygons, arginfo_class_H3_GeoMultiPolygon_getPolygons, ZEND_ACC_PUBLIC)
 	ZEND_ME(H3_GeoMultiPolygon, toGeoJson, arginfo_class_H3_GeoMultiPolygon_toGeoJson, ZEND_ACC_PUBLIC)
+	ZEND_ME(H3_GeoMultiPolygon, toWkb, arginfo_class_H3_GeoMultiPolygon_toWkb, ZEND_ACC_PUBLIC)
 	ZEND_FE_END
 };
 
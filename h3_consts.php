@@ -16,6 +16,18 @@ const H3_LENGTH_UNIT_KM = 0;
 const H3_LENGTH_UNIT_M = 1;
 const H3_LENGTH_UNIT_RADS = 2;
 
+const H3_DISTANCES_NESTED = 0;
+const H3_DISTANCES_MAP = 1;
+const H3_DISTANCES_PACKED = 2;
+
+const H3_OUTPUT_LIST = 0;
+const H3_OUTPUT_SET = 1;
+const H3_OUTPUT_MAP = 2;
+
+const H3_ORDER_INDEX = 0;
+const H3_ORDER_MORTON = 1;
+const H3_ORDER_HILBERT = 2;
+
 // H3 v4 error codes
 const H3_E_SUCCESS = 0;
 const H3_E_FAILED = 1;
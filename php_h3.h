@@ -16,6 +16,16 @@ ZEND_TSRMLS_CACHE_EXTERN()
 ZEND_BEGIN_MODULE_GLOBALS(h3)
     zend_bool validate_res;
     zend_bool validate_index;
+    uint32_t geometry_epoch;
+    zend_long threads;
+    zend_long result_cache_size;
+    HashTable *result_cache;
+    size_t result_cache_bytes;
+    zend_long result_cache_hits;
+    zend_long result_cache_misses;
+    zend_long result_cache_evictions;
+    struct _h3_scratch_block *scratch;
+    size_t scratch_peak;
 ZEND_END_MODULE_GLOBALS(h3);
 // clang-format on
 
@@ -0,0 +1,75 @@
+--TEST--
+H3\GeoPolygon::fromGeoJson() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$ring = [[-122.41, 37.81], [-122.35, 37.72], [-122.48, 37.82], [-122.41, 37.81]];
+$hole = [[-122.42, 37.79], [-122.41, 37.78], [-122.43, 37.78], [-122.42, 37.79]];
+
+$polygon = \H3\GeoPolygon::fromGeoJson(['type' => 'Polygon', 'coordinates' => [$ring, $hole]]);
+
+foreach ($polygon->getGeofence()->getVertices() as $vertex) {
+    var_dump([$vertex->getLon(), $vertex->getLat()]);
+}
+var_dump(count($polygon->getHoles()));
+var_dump(count($polygon->getHoles()[0]->getVertices()));
+
+$fromObjects = new \H3\GeoPolygon(
+    new \H3\CellBoundary(array_map(fn ($p) => new \H3\LatLng($p[1], $p[0]), array_slice($ring, 0, 3))),
+    [new \H3\CellBoundary(array_map(fn ($p) => new \H3\LatLng($p[1], $p[0]), array_slice($hole, 0, 3)))]
+);
+var_dump($polygon == $fromObjects);
+var_dump(\H3\polyfill($polygon, 9) == \H3\polyfill($fromObjects, 9));
+
+$flat = \H3\GeoPolygon::fromGeoJson(array_merge(...$ring));
+var_dump(count($flat->getGeofence()->getVertices()));
+var_dump($flat->getHoles());
+var_dump(\H3\GeoPolygon::fromGeoJson([$ring]) == $flat);
+
+$invalid = [
+    ['type' => 'MultiPolygon', 'coordinates' => [[$ring]]],
+    [[$ring]],
+    [[[-122.41, 'a']]],
+    [$ring, [1, 2]],
+];
+foreach ($invalid as $geometry) {
+    try {
+        \H3\GeoPolygon::fromGeoJson($geometry);
+        var_dump(true);
+    } catch (\H3\H3Exception $e) {
+        var_dump(false);
+    }
+}
+?>
+--EXPECT--
+array(2) {
+  [0]=>
+  float(-122.41)
+  [1]=>
+  float(37.81)
+}
+array(2) {
+  [0]=>
+  float(-122.35)
+  [1]=>
+  float(37.72)
+}
+array(2) {
+  [0]=>
+  float(-122.48)
+  [1]=>
+  float(37.82)
+}
+int(1)
+int(3)
+bool(true)
+bool(true)
+int(3)
+array(0) {
+}
+bool(true)
+bool(false)
+bool(false)
+bool(false)
+bool(false)
@@ -0,0 +1,64 @@
+--TEST--
+H3\H3Index::isIn() and keyed H3_OUTPUT_SET / H3_OUTPUT_MAP output
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$h3 = \H3\H3Index::fromLong(0x8811964009fffff);
+$list = $h3->kRing(1);
+
+$set = $h3->kRing(1, H3_OUTPUT_SET);
+var_dump(count($set));
+var_dump(array_unique($set));
+var_dump(array_keys($set) === array_map(fn ($index) => $index->toLong(), $list));
+
+$map = $h3->kRing(1, H3_OUTPUT_MAP);
+var_dump(count($map));
+var_dump($map[0x8811964047fffff]->toString());
+
+var_dump($h3->isIn($set));
+var_dump(\H3\H3Index::fromLong(0x8811964041fffff)->isIn($set));
+var_dump(\H3\H3Index::fromLong(0x8811964041fffff)->isIn($h3->kRing(2, H3_OUTPUT_SET)));
+var_dump($h3->isIn([]));
+
+$parent = \H3\H3Index::fromLong(0x85283473fffffff);
+$children = $parent->toChildren(7, H3_OUTPUT_SET);
+var_dump(count($children));
+var_dump(\H3\uncompact([$parent], 7, H3_OUTPUT_SET) === $children);
+var_dump(isset($children[$parent->toCenterChild(7)->toLong()]));
+
+$polygon = \H3\GeoPolygon::fromGeoJson([[
+    [-122.4089866999972145, 37.813318999983238],
+    [-122.3544736999993603, 37.7198061999978478],
+    [-122.4798767000009008, 37.8151571999998453],
+]]);
+$cells = \H3\polyfill($polygon, 7);
+$keyed = \H3\polyfill($polygon, 7, H3_OUTPUT_MAP);
+var_dump(count($keyed) === count($cells));
+var_dump(array_keys($keyed) === array_map(fn ($index) => $index->toLong(), $cells));
+
+try {
+    $h3->kRing(1, 5);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+int(7)
+array(1) {
+  [612798941597007871]=>
+  bool(true)
+}
+bool(true)
+int(7)
+string(15) "8811964047fffff"
+bool(true)
+bool(false)
+bool(true)
+bool(false)
+int(343)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+H3\H3Index::kRing(): Argument #2 ($output) must be one of H3_OUTPUT_LIST, H3_OUTPUT_SET, or H3_OUTPUT_MAP
@@ -0,0 +1,76 @@
+--TEST--
+H3\H3Index::kRingDistances() and hexRangeDistances() flat formats
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function nested_to_map(array $rings): array {
+    $map = [];
+    foreach ($rings as $distance => $ring) {
+        foreach ($ring as $index) {
+            $map[$index->toLong()] = $distance;
+        }
+    }
+    ksort($map);
+    return $map;
+}
+
+foreach (['kRingDistances' => 0x8811964009fffff, 'hexRangeDistances' => 0x85119643fffffff] as $method => $long) {
+    $h3 = \H3\H3Index::fromLong($long);
+    $expected = nested_to_map($h3->$method(2, H3_DISTANCES_NESTED));
+
+    $map = $h3->$method(2, H3_DISTANCES_MAP);
+    var_dump(count($map));
+    ksort($map);
+    var_dump($map === $expected);
+
+    $packed = $h3->$method(2, H3_DISTANCES_PACKED);
+    var_dump(array_keys($packed));
+    var_dump(array_is_list($packed['cells']) && array_is_list($packed['distances']));
+    $map = array_combine($packed['cells'], $packed['distances']);
+    ksort($map);
+    var_dump($map === $expected);
+}
+
+var_dump(\H3\H3Index::fromLong(0x8811964009fffff)->kRingDistances(0, H3_DISTANCES_PACKED));
+
+try {
+    \H3\H3Index::fromLong(0x8811964009fffff)->kRingDistances(1, 3);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+int(19)
+bool(true)
+array(2) {
+  [0]=>
+  string(5) "cells"
+  [1]=>
+  string(9) "distances"
+}
+bool(true)
+bool(true)
+int(19)
+bool(true)
+array(2) {
+  [0]=>
+  string(5) "cells"
+  [1]=>
+  string(9) "distances"
+}
+bool(true)
+bool(true)
+array(2) {
+  ["cells"]=>
+  array(1) {
+    [0]=>
+    int(612798941597007871)
+  }
+  ["distances"]=>
+  array(1) {
+    [0]=>
+    int(0)
+  }
+}
+H3\H3Index::kRingDistances(): Argument #2 ($format) must be one of H3_DISTANCES_NESTED, H3_DISTANCES_MAP, or H3_DISTANCES_PACKED
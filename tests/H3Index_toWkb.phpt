@@ -0,0 +1,41 @@
+--TEST--
+H3\H3Index::toWkb() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$index = \H3\H3Index::fromLong(0x85283473fffffff);
+$vertices = $index->toGeoBoundary()->getVertices();
+
+$wkb = $index->toWkb();
+$header = unpack('Corder/Ltype/Lrings/Lpoints', $wkb);
+var_dump($header['order'] === (pack('S', 1) === "\x01\x00" ? 1 : 0));
+var_dump($header['type'], $header['rings'], $header['points']);
+var_dump(strlen($wkb) === 13 + $header['points'] * 16);
+
+$coords = array_values(unpack('d*', substr($wkb, 13)));
+$expected = [];
+foreach ([...$vertices, $vertices[0]] as $vertex) {
+    $expected[] = $vertex->getLon();
+    $expected[] = $vertex->getLat();
+}
+var_dump($coords === $expected);
+
+$ewkb = $index->toWkb(true);
+var_dump(unpack('Ltype/Lsrid', $ewkb, 1));
+var_dump(substr($ewkb, 9) === substr($wkb, 5));
+?>
+--EXPECT--
+bool(true)
+int(3)
+int(1)
+int(7)
+bool(true)
+bool(true)
+array(2) {
+  ["type"]=>
+  int(536870915)
+  ["srid"]=>
+  int(4326)
+}
+bool(true)
@@ -0,0 +1,30 @@
+--TEST--
+H3\cells_contain() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$parent = new \H3\H3Index(0x8428347ffffffff);
+$children = $parent->toChildren(5);
+
+var_dump(\H3\cells_contain([$parent], [0x85283473fffffff, 0x86283472fffffff]));
+var_dump(\H3\cells_contain($children, [$parent]));
+var_dump(\H3\cells_contain(array_slice($children, 1), [$parent]));
+var_dump(\H3\cells_contain([$parent], [0x85283473fffffff, 0x86283081fffffff]));
+var_dump(\H3\cells_contain([0x85283473fffffff], []));
+var_dump(\H3\cells_contain([], [0x85283473fffffff]));
+
+try {
+    \H3\cells_contain([$parent], [0x165283473fffffff]);
+} catch (\H3\H3Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(false)
+bool(false)
+bool(true)
+bool(false)
+H3\cells_contain(): Argument #2 ($b) must contain only valid cells
@@ -0,0 +1,44 @@
+--TEST--
+H3\cells_difference() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$parent = new \H3\H3Index(0x8428347ffffffff);
+$grandchild = 0x86283472fffffff;
+$other = 0x86283081fffffff;
+
+var_dump(array_map('dechex', \H3\cells_difference([$parent], [0x85283473fffffff, $other])));
+
+// matches the difference of the uncompacted sets
+$difference = \H3\cells_difference([$parent], [$grandchild]);
+$expected = array_diff(
+    array_map(fn ($cell) => $cell->toLong(), \H3\uncompact([$parent], 7)),
+    array_map(fn ($cell) => $cell->toLong(), \H3\uncompact([new \H3\H3Index($grandchild)], 7)),
+);
+$uncompacted = array_map(fn ($cell) => $cell->toLong(), \H3\uncompact(array_map(fn ($cell) => new \H3\H3Index($cell), $difference), 7));
+sort($expected);
+sort($uncompacted);
+var_dump(count($difference), $uncompacted === $expected);
+
+var_dump(\H3\cells_difference([0x85283473fffffff], [$parent]));
+?>
+--EXPECT--
+array(6) {
+  [0]=>
+  string(15) "85283463fffffff"
+  [1]=>
+  string(15) "85283467fffffff"
+  [2]=>
+  string(15) "8528346bfffffff"
+  [3]=>
+  string(15) "8528346ffffffff"
+  [4]=>
+  string(15) "85283477fffffff"
+  [5]=>
+  string(15) "8528347bfffffff"
+}
+int(12)
+bool(true)
+array(0) {
+}
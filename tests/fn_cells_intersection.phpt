@@ -0,0 +1,27 @@
+--TEST--
+H3\cells_intersection() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$parent = new \H3\H3Index(0x8428347ffffffff);
+$child = 0x85283473fffffff;
+$other = 0x86283081fffffff;
+
+var_dump(array_map('dechex', \H3\cells_intersection([$parent], [$child, $other])));
+var_dump(array_map('dechex', \H3\cells_intersection([$child, $other], [$parent])));
+var_dump(\H3\cells_intersection([$child], [$other]));
+var_dump(array_values(unpack('Q*', \H3\cells_intersection([$parent], [$parent, $child], true))) === [$parent->toLong()]);
+?>
+--EXPECT--
+array(1) {
+  [0]=>
+  string(15) "85283473fffffff"
+}
+array(1) {
+  [0]=>
+  string(15) "85283473fffffff"
+}
+array(0) {
+}
+bool(true)
@@ -0,0 +1,53 @@
+--TEST--
+H3\cells_to_boundaries() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+// hexagon, pentagon and a class III cell with distortion vertices
+$indexes = [0x85283473fffffff, 0x8009fffffffffff, 0x81083ffffffffff];
+
+$expected = [];
+$expectedOffsets = [0];
+foreach ($indexes as $index) {
+    $vertices = \H3\H3Index::fromLong($index)->toGeoBoundary()->getVertices();
+    foreach ($vertices as $vertex) {
+        $expected[] = $vertex->getLon();
+        $expected[] = $vertex->getLat();
+    }
+    $expectedOffsets[] = end($expectedOffsets) + count($vertices);
+}
+
+$boundaries = \H3\cells_to_boundaries($indexes);
+var_dump($boundaries['offsets'] === $expectedOffsets);
+var_dump($boundaries['coordinates'] === $expected);
+
+$packed = \H3\cells_to_boundaries(pack('Q*', ...$indexes), true);
+var_dump(array_values(unpack('L*', $packed['offsets'])) === $expectedOffsets);
+var_dump(array_values(unpack('d*', $packed['coordinates'])) === $expected);
+
+var_dump(\H3\cells_to_boundaries([]));
+
+try {
+    \H3\cells_to_boundaries(['invalid data']);
+    var_dump(true);
+} catch (\Throwable $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+array(2) {
+  ["coordinates"]=>
+  array(0) {
+  }
+  ["offsets"]=>
+  array(1) {
+    [0]=>
+    int(0)
+  }
+}
+bool(false)
@@ -0,0 +1,42 @@
+--TEST--
+H3\cells_to_center_children() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = [
+    new \H3\H3Index(0x85283473fffffff),
+    0x8009fffffffffff,
+    0x8a2830800007fff,
+];
+
+$children = \H3\cells_to_center_children($cells, 10);
+var_dump($children);
+
+foreach ($cells as $i => $cell) {
+    $cell = $cell instanceof \H3\H3Index ? $cell : \H3\H3Index::fromLong($cell);
+    var_dump($cell->toCenterChild(10)->toLong() === $children[$i]);
+}
+
+var_dump(\H3\cells_to_center_children($cells, 10, true) === pack('Q*', ...$children));
+
+try {
+    \H3\cells_to_center_children($cells, 4);
+} catch (\H3\H3Exception $e) {
+    var_dump($e->getMessage());
+}
+?>
+--EXPECT--
+array(3) {
+  [0]=>
+  int(622204039496499199)
+  [1]=>
+  int(621637486065516543)
+  [2]=>
+  int(622203768913559551)
+}
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+string(26) "Failed to get center child"
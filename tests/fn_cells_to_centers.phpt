@@ -0,0 +1,48 @@
+--TEST--
+H3\cells_to_centers() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    new \H3\H3Index(0x85283473fffffff),
+    0x8009fffffffffff,
+];
+
+$expected = [];
+foreach ($indexes as $index) {
+    $center = ($index instanceof \H3\H3Index ? $index : \H3\H3Index::fromLong($index))->toGeo();
+    $expected[] = $center->getLon();
+    $expected[] = $center->getLat();
+}
+
+$centers = \H3\cells_to_centers($indexes);
+var_dump(count($centers));
+var_dump($centers === $expected);
+
+$packed = pack('Q*', 0x85283473fffffff, 0x8009fffffffffff);
+var_dump(\H3\cells_to_centers($packed) === $expected);
+var_dump(array_values(unpack('d*', \H3\cells_to_centers($packed, true))) === $expected);
+
+var_dump(\H3\cells_to_centers([]));
+var_dump(\H3\cells_to_centers('', true));
+
+foreach ([['invalid data'], 'abc'] as $invalid) {
+    try {
+        \H3\cells_to_centers($invalid);
+        var_dump(true);
+    } catch (\Throwable $e) {
+        var_dump(false);
+    }
+}
+?>
+--EXPECT--
+int(4)
+bool(true)
+bool(true)
+bool(true)
+array(0) {
+}
+string(0) ""
+bool(false)
+bool(false)
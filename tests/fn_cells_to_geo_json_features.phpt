@@ -0,0 +1,55 @@
+--TEST--
+H3\cells_to_geo_json_features() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = \H3\H3Index::fromLong(0x85283473fffffff)->kRing(1);
+$cells['pentagon'] = 0x821c07fffffffff;
+
+$properties = [
+    0 => ['demand' => 1.5, 'name' => 'center'],
+    2 => [],
+    'pentagon' => [7 => true],
+];
+
+$features = [];
+foreach ($cells as $key => $cell) {
+    $cell = $cell instanceof \H3\H3Index ? $cell : \H3\H3Index::fromLong($cell);
+    $ring = [];
+    foreach ($cell->toGeoBoundary()->getVertices() as $vertex) {
+        $ring[] = [$vertex->getLon(), $vertex->getLat()];
+    }
+    $ring[] = $ring[0];
+    $features[] = [
+        'type' => 'Feature',
+        'id' => $cell->toString(),
+        'geometry' => ['type' => 'Polygon', 'coordinates' => [$ring]],
+        'properties' => isset($properties[$key]) ? (object) $properties[$key] : null,
+    ];
+}
+$expected = json_encode(['type' => 'FeatureCollection', 'features' => $features]);
+
+$geojson = \H3\cells_to_geo_json_features($cells, $properties);
+var_dump($geojson === $expected);
+
+$stream = fopen('php://memory', 'w+');
+var_dump(\H3\cells_to_geo_json_features($cells, $properties, $stream) === strlen($expected));
+rewind($stream);
+var_dump(stream_get_contents($stream) === $expected);
+
+var_dump(\H3\cells_to_geo_json_features([]));
+
+try {
+    \H3\cells_to_geo_json_features(['invalid data']);
+    var_dump(true);
+} catch (\Throwable $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+string(42) "{"type":"FeatureCollection","features":[]}"
+bool(false)
@@ -0,0 +1,74 @@
+--TEST--
+H3\cells_to_parents() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = [
+    new \H3\H3Index(0x85283473fffffff),
+    0x85283477fffffff,
+    0x8a2830800007fff,
+    0x85283473fffffff,
+];
+
+$parents = \H3\cells_to_parents($cells, 4);
+var_dump($parents);
+
+foreach ($cells as $i => $cell) {
+    $cell = $cell instanceof \H3\H3Index ? $cell : \H3\H3Index::fromLong($cell);
+    var_dump($cell->toParent(4)->toLong() === $parents[$i]);
+}
+
+var_dump(\H3\cells_to_parents($cells, 4, true) === pack('Q*', ...$parents));
+
+var_dump(\H3\cells_to_parents($cells, 4, false, true));
+
+$counted = \H3\cells_to_parents(pack('Q*', 0x85283473fffffff, 0x85283477fffffff, 0x8a2830800007fff, 0x85283473fffffff), 4, true, true);
+var_dump(array_values(unpack('Q*', $counted['parents'])) === [0x8428347ffffffff, 0x8428309ffffffff]);
+var_dump(array_values(unpack('L*', $counted['counts'])) === [3, 1]);
+
+var_dump(\H3\cells_to_parents([], 4));
+
+try {
+    \H3\cells_to_parents([0x85283473fffffff, 0x8009fffffffffff], 1);
+} catch (\H3\H3Exception $e) {
+    var_dump($e->getMessage());
+}
+?>
+--EXPECT--
+array(4) {
+  [0]=>
+  int(595182446027210751)
+  [1]=>
+  int(595182446027210751)
+  [2]=>
+  int(595182179739238399)
+  [3]=>
+  int(595182446027210751)
+}
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+array(2) {
+  ["parents"]=>
+  array(2) {
+    [0]=>
+    int(595182446027210751)
+    [1]=>
+    int(595182179739238399)
+  }
+  ["counts"]=>
+  array(2) {
+    [0]=>
+    int(3)
+    [1]=>
+    int(1)
+  }
+}
+bool(true)
+bool(true)
+array(0) {
+}
+string(20) "Failed to get parent"
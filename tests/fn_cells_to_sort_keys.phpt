@@ -0,0 +1,44 @@
+--TEST--
+H3\cells_to_sort_keys() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = [
+    0x85283083fffffff,
+    new \H3\H3Index(0x85194ad3fffffff),
+    0x8a2830800007fff,
+];
+
+// A cell and its center child share a center, and so a key
+var_dump(\H3\cells_to_sort_keys($cells));
+var_dump(\H3\cells_to_sort_keys($cells, H3_ORDER_MORTON));
+var_dump(\H3\cells_to_sort_keys($cells, H3_ORDER_INDEX) === [0x85283083fffffff, 0x85194ad3fffffff, 0x8a2830800007fff]);
+var_dump(array_values(unpack('Q*', \H3\cells_to_sort_keys($cells, H3_ORDER_HILBERT, true))) === \H3\cells_to_sort_keys($cells));
+
+try {
+    \H3\cells_to_sort_keys(['invalid']);
+} catch (\H3\H3Exception $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+array(3) {
+  [0]=>
+  int(1359079935641033835)
+  [1]=>
+  int(2013037359799269946)
+  [2]=>
+  int(1359079935641033835)
+}
+array(3) {
+  [0]=>
+  int(2565002297140045634)
+  [1]=>
+  int(3275761179137102063)
+  [2]=>
+  int(2565002297140045634)
+}
+bool(true)
+bool(true)
+bool(false)
@@ -0,0 +1,37 @@
+--TEST--
+H3\cells_to_strings() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = [0x85283473fffffff, new \H3\H3Index(0x8928308280fffff), 0x115283473fffffff, 0];
+
+var_dump(\H3\cells_to_strings($cells));
+var_dump(\H3\cells_to_strings(pack('Q*', 0x85283473fffffff, 0x8928308280fffff), true));
+var_dump(\H3\cells_to_strings([], true));
+
+$index = new \H3\H3Index(0x8928308280fffff);
+var_dump(\H3\cells_to_strings([$index])[0] === $index->toString());
+
+try {
+    \H3\cells_to_strings(['85283473fffffff']);
+} catch (\H3\H3Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+array(4) {
+  [0]=>
+  string(15) "85283473fffffff"
+  [1]=>
+  string(15) "8928308280fffff"
+  [2]=>
+  string(16) "115283473fffffff"
+  [3]=>
+  string(1) "0"
+}
+string(31) "85283473fffffff
+8928308280fffff"
+string(0) ""
+bool(true)
+H3\cells_to_strings(): Argument #1 ($indexes) must be an array of H3Index objects or integers, or a packed string of 64-bit indexes
@@ -0,0 +1,63 @@
+--TEST--
+H3\cells_to_wkb() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    'a' => new \H3\H3Index(0x85283473fffffff),
+    'b' => 0x85283477fffffff,
+];
+
+$wkbs = \H3\cells_to_wkb($indexes);
+var_dump(array_keys($wkbs));
+var_dump($wkbs['a'] === $indexes['a']->toWkb());
+var_dump($wkbs['b'] === \H3\H3Index::fromLong($indexes['b'])->toWkb());
+
+$multi = \H3\cells_to_wkb($indexes, true);
+var_dump(unpack('Corder/Ltype/Lpolygons', $multi));
+var_dump($multi === substr($multi, 0, 9) . $wkbs['a'] . $wkbs['b']);
+
+$ewkb = \H3\cells_to_wkb($indexes, true, true);
+var_dump(unpack('Ltype/Lsrid', $ewkb, 1));
+var_dump(substr($ewkb, 13) === substr($multi, 9));
+
+var_dump(\H3\cells_to_wkb([]));
+var_dump(strlen(\H3\cells_to_wkb([], true)));
+
+try {
+    \H3\cells_to_wkb(['invalid data']);
+    var_dump(true);
+} catch (\Throwable $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+array(2) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  string(1) "b"
+}
+bool(true)
+bool(true)
+array(3) {
+  ["order"]=>
+  int(1)
+  ["type"]=>
+  int(6)
+  ["polygons"]=>
+  int(2)
+}
+bool(true)
+array(2) {
+  ["type"]=>
+  int(536870918)
+  ["srid"]=>
+  int(4326)
+}
+bool(true)
+array(0) {
+}
+int(9)
+bool(false)
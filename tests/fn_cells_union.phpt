@@ -0,0 +1,46 @@
+--TEST--
+H3\cells_union() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$parent = new \H3\H3Index(0x8428347ffffffff);
+$children = array_map(fn ($child) => $child->toLong(), $parent->toChildren(5));
+$other = 0x86283081fffffff;
+
+// siblings from both sides combine into their parent
+var_dump(array_map('dechex', \H3\cells_union(array_slice($children, 0, 4), array_merge(array_slice($children, 3), [$other]))));
+
+var_dump(array_map('dechex', \H3\cells_union([$parent], [$children[4], $other])));
+var_dump(\H3\cells_union(pack('Q*', ...$children), '', true) === pack('Q', $parent->toLong()));
+var_dump(\H3\cells_union([], []));
+
+// a null id, a directed edge and a digit 7 are not cells
+foreach ([[[0], []], [[$other], [0x165283473fffffff]], [[0x8528347ffffffff], [$other]]] as [$a, $b]) {
+    try {
+        \H3\cells_union($a, $b);
+        var_dump(true);
+    } catch (\H3\H3Exception $e) {
+        echo $e->getMessage(), "\n";
+    }
+}
+?>
+--EXPECT--
+array(2) {
+  [0]=>
+  string(15) "86283081fffffff"
+  [1]=>
+  string(15) "8428347ffffffff"
+}
+array(2) {
+  [0]=>
+  string(15) "86283081fffffff"
+  [1]=>
+  string(15) "8428347ffffffff"
+}
+bool(true)
+array(0) {
+}
+H3\cells_union(): Argument #1 ($a) must contain only valid cells
+H3\cells_union(): Argument #2 ($b) must contain only valid cells
+H3\cells_union(): Argument #1 ($a) must contain only valid cells
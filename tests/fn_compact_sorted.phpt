@@ -0,0 +1,45 @@
+--TEST--
+H3\compact() with sorted single resolution input
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function to_strings(array $indexes): array
+{
+    $strings = array_map(fn ($index) => $index->toString(), $indexes);
+    sort($strings);
+    return $strings;
+}
+
+$nearby = (new \H3\H3Index(0x85283473fffffff))->kRing(4);
+$sorted = \H3\sort_cells($nearby);
+
+var_dump(to_strings(\H3\compact($sorted)) === to_strings(\H3\compact($nearby)));
+var_dump(count(\H3\compact($sorted)));
+
+// pentagons have six children
+$pentagon = \H3\H3Index::fromLong(0x8009fffffffffff);
+$children = \H3\sort_cells($pentagon->toChildren(2));
+var_dump(to_strings(\H3\compact($children)));
+
+array_pop($children);
+var_dump(count(\H3\compact($children)) === count(\H3\compact(array_map(fn ($cell) => \H3\H3Index::fromLong($cell), array_reverse($children)))));
+
+// sorted and of one resolution, but not valid cells
+try {
+    \H3\compact([0x05283473fffffff, 0x05283477fffffff]);
+    var_dump(true);
+} catch (\H3\H3Exception $e) {
+    var_dump($e->getMessage(), $e->getCode() === H3_ERR_CODE_COMPACT_ERROR);
+}
+?>
+--EXPECT--
+bool(true)
+int(31)
+array(1) {
+  [0]=>
+  string(15) "8009fffffffffff"
+}
+bool(true)
+string(17) "Failed to compact"
+bool(true)
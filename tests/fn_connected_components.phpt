@@ -0,0 +1,58 @@
+--TEST--
+H3\connected_components() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    0x85283013fffffff,
+    new \H3\H3Index(0x85283473fffffff),
+    0x85283403fffffff,
+    0x85283473fffffff,
+];
+
+echo implode(',', \H3\connected_components($indexes)), "\n";
+echo implode(',', \H3\connected_components($indexes, 0)), "\n";
+echo implode(',', \H3\connected_components($indexes, 2)), "\n";
+echo implode(',', \H3\connected_components($indexes, 5)), "\n";
+echo implode(',', \H3\connected_components(pack('Q*', 0x85283473fffffff, 0x8528340bfffffff, 0x85283403fffffff))), "\n";
+
+foreach (\H3\connected_components($indexes, 1, true) as $component) {
+    echo implode(',', array_map(fn ($index) => $index->toString(), $component)), "\n";
+}
+
+var_dump(\H3\connected_components([]));
+
+foreach ([-1, 1001, PHP_INT_MAX] as $k) {
+    try {
+        \H3\connected_components($indexes, $k);
+    } catch (\ValueError $e) {
+        echo $e->getMessage(), "\n";
+    }
+}
+
+foreach ([['invalid data'], 'abc'] as $invalid) {
+    try {
+        \H3\connected_components($invalid);
+        var_dump(true);
+    } catch (\Throwable $e) {
+        var_dump(false);
+    }
+}
+?>
+--EXPECT--
+0,1,2,1
+0,1,2,1
+0,1,1,1
+0,0,0,0
+0,0,0
+85283013fffffff
+85283473fffffff,85283473fffffff
+85283403fffffff
+array(0) {
+}
+H3\connected_components(): Argument #2 ($k) must be greater than or equal to 0
+H3\connected_components(): Argument #2 ($k) must be less than or equal to 1000
+H3\connected_components(): Argument #2 ($k) must be less than or equal to 1000
+bool(false)
+bool(false)
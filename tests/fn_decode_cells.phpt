@@ -0,0 +1,57 @@
+--TEST--
+H3\decode_cells() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    new \H3\H3Index(0x85283473fffffff),
+    0x8009fffffffffff,
+    0x8a2830800007fff,
+    0x81083ffffffffff,
+];
+
+$decoded = \H3\decode_cells($indexes);
+foreach ($decoded as $name => $values) {
+    echo $name, ': ', implode(',', $values), "\n";
+}
+
+foreach ($indexes as $i => $index) {
+    $index = $index instanceof \H3\H3Index ? $index : \H3\H3Index::fromLong($index);
+    $faces = 0;
+    foreach ($index->getFaces() as $face) {
+        $faces |= 1 << $face;
+    }
+    var_dump([$index->getResolution(), $index->getBaseCell(), (int) $index->isPentagon(), (int) $index->isResClassIII(), $faces]
+        === array_column($decoded, $i));
+}
+
+$packed = \H3\decode_cells(pack('Q*', 0x85283473fffffff, 0x8009fffffffffff, 0x8a2830800007fff, 0x81083ffffffffff), true);
+var_dump(array_values(unpack('C*', $packed['resolution'])) === $decoded['resolution']);
+var_dump(array_values(unpack('C*', $packed['is_pentagon'])) === $decoded['is_pentagon']);
+var_dump(array_values(unpack('L*', $packed['faces'])) === $decoded['faces']);
+
+var_dump(\H3\decode_cells([])['faces']);
+
+try {
+    \H3\decode_cells(['invalid']);
+} catch (\H3\H3Exception $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+resolution: 5,0,10,1
+base_cell: 20,4,20,4
+is_pentagon: 0,1,0,1
+is_class_iii: 1,0,0,1
+faces: 128,31,128,31
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+array(0) {
+}
+bool(false)
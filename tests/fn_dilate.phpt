@@ -0,0 +1,67 @@
+--TEST--
+H3\dilate() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function sorted_strings(array $indexes): array {
+    $strings = array_map(fn ($index) => $index->toString(), $indexes);
+    sort($strings);
+    return $strings;
+}
+
+$index = \H3\H3Index::fromString('89283082803ffff');
+
+var_dump(sorted_strings(\H3\dilate([$index], 1)) === sorted_strings($index->kRing(1)));
+var_dump(count(\H3\dilate([$index], 2)));
+var_dump(count(\H3\dilate([$index], 2, true)));
+var_dump(sorted_strings(\H3\dilate([$index, $index], 0)));
+
+// a res 7 cell next to a res 8 cell is grown at res 8
+$mixed = [0x872830828ffffff, 0x8828308291fffff];
+var_dump(count(\H3\dilate($mixed, 1)));
+var_dump(count(\H3\dilate(pack('Q*', ...$mixed), 1, true)));
+
+var_dump(\H3\dilate([], 3));
+
+try {
+    \H3\dilate([$index], -1);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+try {
+    \H3\dilate([$index], 1001);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+// a disk wider than the 122 cells of res 0
+try {
+    \H3\dilate([0x8001fffffffffff], 7);
+} catch (\H3\H3Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+
+try {
+    \H3\dilate([0x1], 1);
+} catch (\H3\H3Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+bool(true)
+int(19)
+int(13)
+array(1) {
+  [0]=>
+  string(15) "89283082803ffff"
+}
+int(24)
+int(12)
+array(0) {
+}
+H3\dilate(): Argument #2 ($k) must be greater than or equal to 0
+H3\dilate(): Argument #2 ($k) must be less than or equal to 1000
+H3\dilate(): Argument #2 ($k) must not exceed the size of the grid at the resolution of the cells
+Invalid H3 index
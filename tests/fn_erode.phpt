@@ -0,0 +1,51 @@
+--TEST--
+H3\erode() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function sorted_strings(array $indexes): array {
+    $strings = array_map(fn ($index) => $index->toString(), $indexes);
+    sort($strings);
+    return $strings;
+}
+
+$index = \H3\H3Index::fromString('89283082803ffff');
+$parent = \H3\H3Index::fromString('872830828ffffff');
+
+var_dump(sorted_strings(\H3\erode($index->kRing(2), 1)) === sorted_strings($index->kRing(1)));
+var_dump(count(\H3\erode($parent->toChildren(9), 1)));
+var_dump(count(\H3\erode($parent->toChildren(9), 1, true)));
+var_dump(sorted_strings(\H3\erode($parent->toChildren(9), 2, true)));
+var_dump(count(\H3\erode([$parent], 0)));
+var_dump(\H3\erode([$parent], 1));
+
+// compacted input is eroded at its finest resolution
+var_dump(sorted_strings(\H3\erode(pack('Q*', 0x872830828ffffff, 0x8828308291fffff), 1)));
+var_dump(count(\H3\erode($parent->toChildren(10), 3)));
+var_dump(count(\H3\erode([$parent, 0x8a2830800007fff], 3)));
+
+try {
+    \H3\erode([$index], -1);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+bool(true)
+int(25)
+int(19)
+array(1) {
+  [0]=>
+  string(15) "8828308281fffff"
+}
+int(1)
+array(0) {
+}
+array(1) {
+  [0]=>
+  string(15) "8828308281fffff"
+}
+int(139)
+int(139)
+H3\erode(): Argument #2 ($k) must be greater than or equal to 0
@@ -0,0 +1,42 @@
+--TEST--
+H3\find_descendants() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$ancestor = new \H3\H3Index(0x8428347ffffffff);
+$cells = [
+    0x85283473fffffff,
+    new \H3\H3Index(0x85283477fffffff),
+    0x8a2830800007fff,
+    0x8428347ffffffff,
+    0x8009fffffffffff,
+];
+
+var_dump(\H3\find_descendants($cells, $ancestor));
+var_dump(bin2hex(\H3\find_descendants($cells, $ancestor, true)));
+
+foreach ($cells as $i => $cell) {
+    $cell = $cell instanceof \H3\H3Index ? $cell : \H3\H3Index::fromLong($cell);
+    $expected = $cell->getResolution() >= 4 && $cell->toParent(4)->toLong() === $ancestor->toLong();
+    var_dump($expected === in_array($i, \H3\find_descendants($cells, $ancestor), true));
+}
+
+var_dump(\H3\find_descendants('', $ancestor, true));
+?>
+--EXPECT--
+array(3) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(1)
+  [2]=>
+  int(3)
+}
+string(2) "0b"
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+string(0) ""
@@ -0,0 +1,47 @@
+--TEST--
+H3\h3_set_to_geo_json() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    new \H3\H3Index(0x872830828ffffff),
+    new \H3\H3Index(0x87283082effffff),
+    new \H3\H3Index(0x85119643fffffff),
+];
+
+$geojson = \H3\h3_set_to_geo_json($indexes);
+$expected = json_encode([
+    'type' => 'MultiPolygon',
+    'coordinates' => \H3\h3_set_to_multi_polygon($indexes)->toGeoJson(),
+]);
+var_dump($geojson === $expected);
+
+$ring = \H3\H3Index::fromLong(0x85119643fffffff)->hexRing(3);
+var_dump(\H3\h3_set_to_geo_json($ring) === json_encode([
+    'type' => 'MultiPolygon',
+    'coordinates' => \H3\h3_set_to_multi_polygon($ring)->toGeoJson(),
+]));
+
+$stream = fopen('php://memory', 'w+');
+$written = \H3\h3_set_to_geo_json($indexes, $stream);
+rewind($stream);
+var_dump($written === strlen($geojson));
+var_dump(stream_get_contents($stream) === $geojson);
+
+var_dump(\H3\h3_set_to_geo_json([]));
+
+try {
+    \H3\h3_set_to_geo_json(['invalid data']);
+    var_dump(true);
+} catch (\Throwable $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+string(40) "{"type":"MultiPolygon","coordinates":[]}"
+bool(false)
@@ -0,0 +1,65 @@
+--TEST--
+H3\h3_set_to_wkb() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    new \H3\H3Index(0x872830828ffffff),
+    new \H3\H3Index(0x87283082effffff),
+    new \H3\H3Index(0x85119643fffffff),
+];
+
+$wkb = \H3\h3_set_to_wkb($indexes);
+var_dump(unpack('Corder/Ltype/Lpolygons', $wkb));
+var_dump($wkb === \H3\h3_set_to_multi_polygon($indexes)->toWkb());
+
+$ring = \H3\H3Index::fromLong(0x85119643fffffff)->hexRing(3);
+$ringWkb = \H3\h3_set_to_wkb($ring);
+var_dump(unpack('Lpolygons/Ccorder/Lptype/Lrings', $ringWkb, 5));
+var_dump($ringWkb === \H3\h3_set_to_multi_polygon($ring)->toWkb());
+
+$ewkb = \H3\h3_set_to_wkb($indexes, true);
+var_dump(unpack('Ltype/Lsrid', $ewkb, 1));
+var_dump(substr($ewkb, 9) === substr($wkb, 5));
+var_dump($ewkb === \H3\h3_set_to_multi_polygon($indexes)->toWkb(true));
+
+var_dump(bin2hex(\H3\h3_set_to_wkb([])));
+
+try {
+    \H3\h3_set_to_wkb(['invalid data']);
+    var_dump(true);
+} catch (\Throwable $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+array(3) {
+  ["order"]=>
+  int(1)
+  ["type"]=>
+  int(6)
+  ["polygons"]=>
+  int(2)
+}
+bool(true)
+array(4) {
+  ["polygons"]=>
+  int(1)
+  ["corder"]=>
+  int(1)
+  ["ptype"]=>
+  int(3)
+  ["rings"]=>
+  int(2)
+}
+bool(true)
+array(2) {
+  ["type"]=>
+  int(536870918)
+  ["srid"]=>
+  int(4326)
+}
+bool(true)
+bool(true)
+string(18) "010600000000000000"
@@ -0,0 +1,72 @@
+--TEST--
+H3\polyfill_budget() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function to_strings(array $indexes): array {
+    return array_map(fn ($index) => $index->toString(), $indexes);
+}
+
+function resolutions(array $indexes): array {
+    $counts = array_count_values(array_map(fn ($index) => $index->getResolution(), $indexes));
+    ksort($counts);
+    return $counts;
+}
+
+$polygon = new \H3\GeoPolygon(
+    new \H3\CellBoundary([
+        new \H3\LatLng(37.813318999983238, -122.4089866999972145),
+        new \H3\LatLng(37.7198061999978478, -122.3544736999993603),
+        new \H3\LatLng(37.8151571999998453, -122.4798767000009008),
+    ])
+);
+
+$ring = [
+    [-122.4089866999972145, 37.813318999983238],
+    [-122.3544736999993603, 37.7198061999978478],
+    [-122.4798767000009008, 37.8151571999998453],
+    [-122.4089866999972145, 37.813318999983238],
+];
+
+// resolution 7 has 7 cells, resolution 8 has 44
+$cells = \H3\polyfill_budget($polygon, 40);
+var_dump(to_strings($cells) === to_strings(\H3\polyfill($polygon, 7)));
+var_dump(to_strings(\H3\polyfill_budget([$ring], 40)) === to_strings($cells));
+var_dump(count(\H3\polyfill_budget($polygon, 44)));
+
+$mixed = \H3\polyfill_budget($polygon, 40, true);
+var_dump(count($mixed));
+var_dump(resolutions($mixed));
+
+var_dump(resolutions(\H3\polyfill_budget($polygon, 1, true)));
+
+try {
+    \H3\polyfill_budget($polygon, 0);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+try {
+    \H3\polyfill_budget('polygon', 10);
+} catch (\TypeError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+int(44)
+int(37)
+array(2) {
+  [7]=>
+  int(3)
+  [8]=>
+  int(34)
+}
+array(1) {
+  [4]=>
+  int(1)
+}
+H3\polyfill_budget(): Argument #2 ($max_cells) must be greater than 0
+H3\polyfill_budget(): Argument #1 ($polygon) must be of type H3\GeoPolygon|array, string given
@@ -0,0 +1,47 @@
+--TEST--
+H3\polyfill() reuses and invalidates cached polygons
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function to_strings(array $indexes): array {
+    return array_map(fn ($index) => $index->toString(), $indexes);
+}
+
+$a = new \H3\LatLng(37.813318999983238, -122.4089866999972145);
+$b = new \H3\LatLng(37.7198061999978478, -122.3544736999993603);
+$c = new \H3\LatLng(37.8151571999998453, -122.4798767000009008);
+$geofence = new \H3\CellBoundary([$a, $b, $c]);
+$polygon = new \H3\GeoPolygon($geofence);
+
+$first = to_strings(\H3\polyfill($polygon, 7));
+var_dump(count($first));
+var_dump(to_strings(\H3\polyfill($polygon, 7)) === $first);
+
+$clone = clone $polygon;
+var_dump(to_strings(\H3\polyfill($clone, 7)) === $first);
+var_dump(to_strings(\H3\polyfill(new \H3\GeoPolygon(clone $geofence), 7)) === $first);
+
+// reconstructing a vertex invalidates polygons built from it
+$b->__construct(37.6, -122.3);
+$fresh = new \H3\GeoPolygon(new \H3\CellBoundary([
+    new \H3\LatLng(37.813318999983238, -122.4089866999972145),
+    new \H3\LatLng(37.6, -122.3),
+    new \H3\LatLng(37.8151571999998453, -122.4798767000009008),
+]));
+$moved = to_strings(\H3\polyfill($polygon, 7));
+var_dump($moved !== $first);
+var_dump($moved === to_strings(\H3\polyfill($fresh, 7)));
+
+// as does reconstructing the polygon itself
+$polygon->__construct(new \H3\CellBoundary([$a, new \H3\LatLng(37.7198061999978478, -122.3544736999993603), $c]));
+var_dump(to_strings(\H3\polyfill($polygon, 7)) === $first);
+?>
+--EXPECT--
+int(7)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
@@ -0,0 +1,72 @@
+--TEST--
+H3\polyfill() GeoJSON and flat array input
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+function to_strings(array $indexes): array {
+    return array_map(fn ($index) => $index->toString(), $indexes);
+}
+
+$expected = to_strings(\H3\polyfill(new \H3\GeoPolygon(
+    new \H3\CellBoundary([
+        new \H3\LatLng(37.813318999983238, -122.4089866999972145),
+        new \H3\LatLng(37.7198061999978478, -122.3544736999993603),
+        new \H3\LatLng(37.8151571999998453, -122.4798767000009008),
+    ])
+), 7));
+
+$ring = [
+    [-122.4089866999972145, 37.813318999983238],
+    [-122.3544736999993603, 37.7198061999978478],
+    [-122.4798767000009008, 37.8151571999998453],
+    [-122.4089866999972145, 37.813318999983238],
+];
+
+var_dump(to_strings(\H3\polyfill([$ring], 7)) === $expected);
+var_dump(to_strings(\H3\polyfill(['type' => 'Polygon', 'coordinates' => [$ring]], 7)) === $expected);
+var_dump(to_strings(\H3\polyfill(array_merge(...$ring), 7)) === $expected);
+
+$geometry = json_decode(json_encode(['type' => 'Polygon', 'coordinates' => [$ring]]), true);
+var_dump(to_strings(\H3\polyfill($geometry, 7)) === $expected);
+
+$other = [[[-122.2, 37.5], [-122.1, 37.5], [-122.1, 37.6], [-122.2, 37.6]]];
+$multi = to_strings(\H3\polyfill(['type' => 'MultiPolygon', 'coordinates' => [[$ring], $other]], 7));
+var_dump($multi === array_merge($expected, to_strings(\H3\polyfill($other, 7))));
+var_dump(to_strings(\H3\polyfill([[$ring], $other], 7)) === $multi);
+
+$invalid = [
+    [],
+    [1.0, 2.0, 3.0],
+    [[[-122.4, 'a']]],
+    ['type' => 'Point', 'coordinates' => [-122.4, 37.8]],
+    ['type' => 'Polygon', 'coordinates' => [[$ring]]],
+];
+foreach ($invalid as $polygon) {
+    try {
+        \H3\polyfill($polygon, 7);
+        var_dump(true);
+    } catch (\H3\H3Exception $e) {
+        var_dump(false);
+    }
+}
+
+try {
+    \H3\polyfill('invalid', 7);
+} catch (\TypeError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(false)
+bool(false)
+bool(false)
+bool(false)
+bool(false)
+H3\polyfill(): Argument #1 ($polygon) must be of type H3\GeoPolygon|array, string given
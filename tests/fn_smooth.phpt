@@ -0,0 +1,97 @@
+--TEST--
+H3\smooth() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$values = [
+    0x89283082803ffff => 10,
+    0x89283082807ffff => 4,
+    0x89283082833ffff => 1,
+    0x89283082953ffff => 7,
+];
+
+var_dump(array_values(\H3\smooth($values, 1)));
+var_dump(array_values(\H3\smooth($values, 2, [4, 2, 1], false)));
+var_dump(round(\H3\smooth($values, 2, [4, 2, 1])[0x89283082833ffff], 6));
+var_dump(\H3\smooth($values, 0) === array_map('floatval', $values));
+
+var_dump(\H3\smooth(['89283082803ffff' => 10, '89283082807ffff' => 4.5], 1));
+var_dump(\H3\smooth([], 2));
+
+try {
+    \H3\smooth($values, 2, [1, 1]);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+try {
+    \H3\smooth($values, -1);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+try {
+    \H3\smooth($values, 2147483647);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+// a disk wider than the 122 cells of res 0
+try {
+    \H3\smooth([0x8001fffffffffff => 1], 7);
+} catch (\H3\H3Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+var_dump(\H3\smooth([], 7));
+
+foreach ([['invalid' => 1], [1 => 1], [0x89283082803ffff => 'abc'], ['89283082803ffff' => 1, 0x89283082803ffff => 2]] as $invalid) {
+    try {
+        \H3\smooth($invalid, 1);
+        var_dump(true);
+    } catch (\H3\H3Exception $e) {
+        var_dump(false);
+    }
+}
+?>
+--EXPECT--
+array(4) {
+  [0]=>
+  float(7)
+  [1]=>
+  float(5)
+  [2]=>
+  float(2.5)
+  [3]=>
+  float(7)
+}
+array(4) {
+  [0]=>
+  float(49)
+  [1]=>
+  float(38)
+  [2]=>
+  float(22)
+  [3]=>
+  float(28)
+}
+float(3.142857)
+bool(true)
+array(2) {
+  ["89283082803ffff"]=>
+  float(7.25)
+  ["89283082807ffff"]=>
+  float(7.25)
+}
+array(0) {
+}
+H3\smooth(): Argument #3 ($weights) must contain one weight per ring from 0 to k
+H3\smooth(): Argument #2 ($k) must be greater than or equal to 0
+H3\smooth(): Argument #2 ($k) must be less than or equal to 1000
+H3\smooth(): Argument #2 ($k) must not exceed the size of the grid at the resolution of the cells
+array(0) {
+}
+bool(false)
+bool(false)
+bool(false)
+bool(false)
@@ -0,0 +1,71 @@
+--TEST--
+H3\sort_cells() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = [
+    0x85283083fffffff,
+    new \H3\H3Index(0x85194ad3fffffff),
+    0x85be0e37fffffff,
+    0x852f5a37fffffff,
+    0x852a1073fffffff,
+    0x85a8100ffffffff,
+    0x85194ad3fffffff,
+];
+
+$expected = array_map(fn ($cell) => $cell instanceof \H3\H3Index ? $cell->toLong() : $cell, $cells);
+sort($expected);
+var_dump(\H3\sort_cells($cells) === $expected);
+var_dump(\H3\sort_cells(pack('Q*', ...array_reverse($expected)), H3_ORDER_INDEX, true) === pack('Q*', ...$expected));
+
+// Southern cells first, then west to east within each half
+var_dump(array_map('dechex', \H3\sort_cells($cells, H3_ORDER_MORTON)));
+var_dump(array_map('dechex', \H3\sort_cells($cells, H3_ORDER_HILBERT)));
+
+var_dump(\H3\sort_cells([]));
+
+try {
+    \H3\sort_cells($cells, 5);
+} catch (\ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+array(7) {
+  [0]=>
+  string(15) "85a8100ffffffff"
+  [1]=>
+  string(15) "85be0e37fffffff"
+  [2]=>
+  string(15) "85283083fffffff"
+  [3]=>
+  string(15) "852a1073fffffff"
+  [4]=>
+  string(15) "85194ad3fffffff"
+  [5]=>
+  string(15) "85194ad3fffffff"
+  [6]=>
+  string(15) "852f5a37fffffff"
+}
+array(7) {
+  [0]=>
+  string(15) "85a8100ffffffff"
+  [1]=>
+  string(15) "85283083fffffff"
+  [2]=>
+  string(15) "85194ad3fffffff"
+  [3]=>
+  string(15) "85194ad3fffffff"
+  [4]=>
+  string(15) "852a1073fffffff"
+  [5]=>
+  string(15) "852f5a37fffffff"
+  [6]=>
+  string(15) "85be0e37fffffff"
+}
+array(0) {
+}
+H3\sort_cells(): Argument #2 ($order) must be one of H3_ORDER_INDEX, H3_ORDER_MORTON, or H3_ORDER_HILBERT
@@ -0,0 +1,40 @@
+--TEST--
+H3\strings_to_cells() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+var_dump(\H3\strings_to_cells(['85283473fffffff', '8928308280FFFFF', '115283473fffffff']) === [0x85283473fffffff, 0x8928308280fffff, 0x115283473fffffff]);
+
+$id = '85283473fffffff';
+$refs = [&$id];
+var_dump(\H3\strings_to_cells($refs) === [0x85283473fffffff]);
+
+var_dump(\H3\strings_to_cells("85283473fffffff\r\n\n8928308280fffff\n") === [0x85283473fffffff, 0x8928308280fffff]);
+var_dump(\H3\strings_to_cells("85283473fffffff\n8928308280fffff", true) === pack('Q*', 0x85283473fffffff, 0x8928308280fffff));
+var_dump(\H3\strings_to_cells(''));
+
+$joined = \H3\cells_to_strings([0x85283473fffffff, 0x8928308280fffff], true);
+var_dump(\H3\strings_to_cells($joined) === [0x85283473fffffff, 0x8928308280fffff]);
+
+foreach (["85283473fffffff\nnot hex", ['85283473fffffff', 0x8928308280fffff], ['zz'], [' 0x115283473fffffff'], "85283473fffffff\n 0x115283473fffffff"] as $strings) {
+    try {
+        \H3\strings_to_cells($strings);
+    } catch (\H3\H3Exception $e) {
+        echo $e->getMessage(), "\n";
+    }
+}
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+array(0) {
+}
+bool(true)
+H3\strings_to_cells(): Argument #1 ($strings) must be an array of H3 index strings, or a newline-separated string of them
+H3\strings_to_cells(): Argument #1 ($strings) must be an array of H3 index strings, or a newline-separated string of them
+H3\strings_to_cells(): Argument #1 ($strings) must be an array of H3 index strings, or a newline-separated string of them
+H3\strings_to_cells(): Argument #1 ($strings) must be an array of H3 index strings, or a newline-separated string of them
+H3\strings_to_cells(): Argument #1 ($strings) must be an array of H3 index strings, or a newline-separated string of them
@@ -0,0 +1,35 @@
+--TEST--
+H3\unique_cells() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$cells = [
+    0x85283083fffffff,
+    0x85194ad3fffffff,
+    new \H3\H3Index(0x85283083fffffff),
+    0x8a2830800007fff,
+    0x85194ad3fffffff,
+    0x85283083fffffff,
+];
+
+var_dump(\H3\unique_cells($cells));
+var_dump(array_values(unpack('Q*', \H3\unique_cells($cells, H3_ORDER_MORTON, true))));
+?>
+--EXPECT--
+array(3) {
+  [0]=>
+  int(599423697240981503)
+  [1]=>
+  int(599685771850416127)
+  [2]=>
+  int(622203768913559551)
+}
+array(3) {
+  [0]=>
+  int(599685771850416127)
+  [1]=>
+  int(622203768913559551)
+  [2]=>
+  int(599423697240981503)
+}
@@ -0,0 +1,57 @@
+--TEST--
+H3\validate_cells() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    0x85283473fffffff,
+    0x85283473ffffff8,
+    new \H3\H3Index(0x8009fffffffffff),
+    0x80083ffffffffff,
+    0x81087ffffffffff,
+    0x8108bffffffffff,
+    0x145283473fffffff,
+    0,
+    0x821c07fffffffff,
+];
+
+var_dump(\H3\validate_cells($indexes));
+
+$packed = pack('Q*', ...array_map(fn ($index) => $index instanceof \H3\H3Index ? $index->toLong() : $index, $indexes));
+var_dump(bin2hex(\H3\validate_cells($packed, true)));
+
+foreach ($indexes as $i => $index) {
+    $index = $index instanceof \H3\H3Index ? $index : \H3\H3Index::fromLong($index);
+    if ($index->isValid() === in_array($i, \H3\validate_cells($packed), true)) {
+        echo "mismatch at $i\n";
+    }
+}
+
+var_dump(\H3\validate_cells([]));
+var_dump(\H3\validate_cells('', true));
+
+try {
+    \H3\validate_cells(['invalid']);
+} catch (\H3\H3Exception $e) {
+    var_dump(false);
+}
+?>
+--EXPECT--
+array(5) {
+  [0]=>
+  int(1)
+  [1]=>
+  int(3)
+  [2]=>
+  int(4)
+  [3]=>
+  int(6)
+  [4]=>
+  int(7)
+}
+string(4) "da00"
+array(0) {
+}
+string(0) ""
+bool(false)
@@ -0,0 +1,28 @@
+--TEST--
+H3\validate_directed_edges() Test
+--EXTENSIONS--
+h3
+--FILE--
+<?php
+$indexes = [
+    0x145283473fffffff,
+    0x85283473fffffff,
+    0x175283473fffffff,
+    0x115283473fffffff,
+    0x11009fffffffffff,
+    0x12009fffffffffff,
+];
+
+var_dump(\H3\validate_directed_edges($indexes));
+var_dump(bin2hex(\H3\validate_directed_edges($indexes, true)));
+?>
+--EXPECT--
+array(3) {
+  [0]=>
+  int(1)
+  [1]=>
+  int(2)
+  [2]=>
+  int(4)
+}
+string(2) "16"
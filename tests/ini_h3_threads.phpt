@@ -0,0 +1,48 @@
+--TEST--
+h3.threads gives the same polyfill() and compact() results as a single thread
+--EXTENSIONS--
+h3
+--INI--
+h3.threads=4
+--FILE--
+<?php
+function sorted_longs(array $indexes): array {
+    $longs = array_map(fn ($index) => $index->toLong(), $indexes);
+    sort($longs);
+    return $longs;
+}
+
+$polygon = \H3\GeoPolygon::fromGeoJson([[
+    [-122.4089866999972145, 37.813318999983238],
+    [-122.3544736999993603, 37.7198061999978478],
+    [-122.4798767000009008, 37.8151571999998453],
+], [
+    [-122.41, 37.79], [-122.40, 37.78], [-122.42, 37.78],
+]]);
+$children = \H3\H3Index::fromLong(0x832830fffffffff)->toChildren(8);
+array_pop($children);
+
+var_dump(ini_get('h3.threads'));
+$threaded = sorted_longs(\H3\polyfill($polygon, 12));
+// ascending ids of one resolution take the streaming path, so reverse them
+// to reach the threaded one
+$threadedCompact = \H3\compact(array_reverse($children));
+$sortedCompact = \H3\compact($children);
+
+// h3.threads is system-wide, so compare against the single-threaded results
+// recorded from libh3
+var_dump(count($threaded));
+var_dump(md5(implode(',', $threaded)));
+var_dump(count($threadedCompact));
+var_dump(sorted_longs(\H3\uncompact($threadedCompact, 8)) === sorted_longs($children));
+var_dump(sorted_longs($sortedCompact) === sorted_longs($threadedCompact));
+var_dump(ini_set('h3.threads', '1'));
+?>
+--EXPECT--
+string(1) "4"
+int(96955)
+string(32) "91aa9fd3361cd59ef1672b3fd4de0a9c"
+int(30)
+bool(true)
+bool(true)
+bool(false)
@@ -0,0 +1,44 @@
+--TEST--
+h3.threads gives the same h3_set_to_geo_json() outlines as a single thread
+--EXTENSIONS--
+h3
+--INI--
+h3.threads=4
+--FILE--
+<?php
+function outline(array $indexes): array {
+    $polygons = array_map(function ($polygon) {
+        $vertices = array_map(fn ($vertex) => sprintf('%.9f,%.9f', $vertex[0], $vertex[1]), array_merge(...$polygon));
+        sort($vertices);
+        return count($polygon) . ':' . implode(';', $vertices);
+    }, json_decode(\H3\h3_set_to_geo_json($indexes), true)['coordinates']);
+    sort($polygons);
+    return $polygons;
+}
+
+$first = [];
+foreach (\H3\H3Index::fromLong(0x832830fffffffff)->toChildren(8) as $i => $cell) {
+    if ($i % 7 !== 3) {
+        $first[] = $cell;
+    }
+}
+$second = \H3\H3Index::fromLong(0x83291efffffffff)->toChildren(8);
+$cells = array_merge($first, $second);
+
+$threaded = outline($cells);
+
+// The two components are far apart, so the outline of the whole set is the
+// outlines of each, traced separately
+$single = array_merge(outline($first), outline($second));
+sort($single);
+
+var_dump(count($cells) > 16384);
+var_dump(count($first) < 16384);
+var_dump(count($single));
+var_dump($threaded === $single);
+?>
+--EXPECT--
+bool(true)
+bool(true)
+int(2)
+bool(true)
@@ -0,0 +1,66 @@
+--TEST--
+h3.result_cache_size caches polyfill() results and evicts the least recently used
+--EXTENSIONS--
+h3
+--INI--
+h3.result_cache_size=600
+--FILE--
+<?php
+function to_strings(array $indexes): array {
+    return array_map(fn ($index) => $index->toString(), $indexes);
+}
+
+function stats(): void {
+    $stats = \H3\result_cache_stats();
+    printf("entries=%d hits=%d misses=%d evictions=%d fits=%d\n",
+        $stats['entries'], $stats['hits'], $stats['misses'], $stats['evictions'], $stats['bytes'] <= $stats['max_bytes']);
+}
+
+$polygon = new \H3\GeoPolygon(
+    new \H3\CellBoundary([
+        new \H3\LatLng(37.813318999983238, -122.4089866999972145),
+        new \H3\LatLng(37.7198061999978478, -122.3544736999993603),
+        new \H3\LatLng(37.8151571999998453, -122.4798767000009008),
+    ])
+);
+
+$first = to_strings(\H3\polyfill($polygon, 7));
+stats();
+var_dump(to_strings(\H3\polyfill($polygon, 7)) === $first);
+var_dump(count(\H3\polyfill($polygon, 7, H3_OUTPUT_SET)));
+stats();
+
+// 7 and 8 fill the cache, so adding 6 evicts 8, the least recently used
+\H3\polyfill($polygon, 8);
+\H3\polyfill($polygon, 7);
+\H3\polyfill($polygon, 6);
+stats();
+var_dump(count(\H3\polyfill($polygon, 8)));
+stats();
+
+// 9 alone is larger than the cache
+var_dump(count(\H3\polyfill($polygon, 9)));
+var_dump(count(\H3\polyfill($polygon, 9)));
+stats();
+
+\H3\result_cache_clear();
+stats();
+
+// The cache is persistent, so only the system configuration sizes it
+var_dump(ini_set('h3.result_cache_size', '0'));
+var_dump(ini_get('h3.result_cache_size'));
+?>
+--EXPECT--
+entries=1 hits=0 misses=1 evictions=0 fits=1
+bool(true)
+int(7)
+entries=1 hits=2 misses=1 evictions=0 fits=1
+entries=2 hits=3 misses=3 evictions=1 fits=1
+int(44)
+entries=2 hits=3 misses=4 evictions=2 fits=1
+int(292)
+int(292)
+entries=2 hits=3 misses=6 evictions=2 fits=1
+entries=0 hits=0 misses=0 evictions=0 fits=1
+bool(false)
+string(3) "600"